@@ -1,38 +1,149 @@
 #ifndef __CONSTANTS_HPP
 #define __CONSTANTS_HPP
 
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
 #include "colsim/common.hpp"
-#include "colsim/settings.hpp"
+#include "colsim/run_config.hpp"
 
 namespace colsim
 {
+	/** Coefficients of the QCD beta function for @a nf active flavours.
+	 */
+	constexpr double qcd_beta0(uint nf) { return (11.0/6.0)*CA - (2.0/3.0)*TR*nf; }
+	constexpr double qcd_beta1(uint nf) { return (17.0/6.0)*CA*CA - ((5.0/3.0)*CA + CF)*TR*nf; }
+
+
 	/** Class for determining values of the QCD running coupling
 	 */
 	class AlphaS
 	{
+	public:
+		static constexpr double ALPHAS_Z = 0.118;
+
+		// the lookup table covers this range of t in GeV^2,
+		// outside of which alpha_s is computed directly
+		static constexpr double TABLE_T_MIN = 1.0;
+		static constexpr double TABLE_T_MAX = 1.0e8;
+		// each factor of two in t is split into 2^TABLE_OCTAVE_BITS intervals,
+		// on which 1/alpha_s is a cubic fitted to the exact value at four points;
+		// the relative error of the table is then below 2e-9 at LO and NLO,
+		// largest at the low end of the table where alpha_s runs fastest
+		static constexpr uint TABLE_OCTAVE_BITS = 5;
+
+		static constexpr double beta0(uint nf) { return qcd_beta0(nf); }
+		static constexpr double beta1(uint nf) { return qcd_beta1(nf); }
+
+	private:
+		// beta coefficients as they appear in the running,
+		// b0 = beta0/(2 pi) and b1 = beta1/(2 pi)^2, indexed by the number of flavours
+		static constexpr uint MAX_FLAVOURS = 6;
+		static constexpr std::array<double, MAX_FLAVOURS+1> B0 = []{
+			std::array<double, MAX_FLAVOURS+1> b{};
+			for (uint nf=0; nf<=MAX_FLAVOURS; nf++)
+				b[nf] = qcd_beta0(nf) / (2.0*PI);
+			return b;
+		}();
+		static constexpr std::array<double, MAX_FLAVOURS+1> B1 = []{
+			std::array<double, MAX_FLAVOURS+1> b{};
+			for (uint nf=0; nf<=MAX_FLAVOURS; nf++)
+				b[nf] = qcd_beta1(nf) / (4.0*PI*PI);
+			return b;
+		}();
+
+		// an interval of the table spans this many units
+		// in the bit pattern of t, i.e. of its mantissa
+		static constexpr uint TABLE_SHIFT = 52 - TABLE_OCTAVE_BITS;
+
+		/** Running between two flavour thresholds, starting from
+		 *  @a asref at @a tref, along with its part of the lookup table.
+		 */
+		struct FlavourRegion
+		{
+			double tref, asref;
+			double b0, b1;
+
+			// bit pattern of t at the start of the first interval, and
+			// the cubic for 1/alpha_s in the fractional position u in [0,1)
+			// of t within each interval, lowest power first
+			uint64_t first_bits;
+			std::vector<std::array<double, 4>> inv_alphas{};
+		};
+
 		uint _order; // perturbative order
 		double _alphas_b, _alphas_c; // calced values of alphaS at B and C masses
+		bool _fixed_scale;
 		double _fixed_scale_val;
+		double _cutoff; // lowest scale of the shower
 
-	public:
-		static constexpr double ALPHAS_Z = 0.118;
+		// regions with 3, 4 and 5 active flavours
+		std::array<FlavourRegion, 3> _regions;
 
-		AlphaS(uint _order)
-			: _order{_order},
-			  _alphas_b{calc_alphas(B_MASS_2)}, _alphas_c{calc_alphas(C_MASS_2)},
-			  _fixed_scale_val{SETTINGS.initial_evol_e/2.0}
-		{}
+	public:
+		AlphaS(uint _order, RunConfig const& config);
 
-	    double beta0(uint nf) const;
-		double beta1(uint nf) const;
+		/** Value of alpha_s at @a t computed from scratch.
+		 */
 		double calc_alphas(double t) const;
+
+		/** Value of alpha_s at @a t from the lookup table. The table has a
+		 *  separate grid for each number of flavours, so no interpolation
+		 *  crosses a threshold.
+		 */
+		inline double alphas(double t) const
+		{
+			if (t < TABLE_T_MIN || t >= TABLE_T_MAX)
+				return calc_alphas(t);
+			return lookup(region(t), t);
+		}
+
+		/** Fills @a out with alpha_s at each of @a ts from the lookup table.
+		 */
+		void alphas(std::span<const double> ts, std::span<double> out) const;
+
+		/** Renormalisation scale in GeV of an emission at @a t with
+		 *  momentum fraction @a z: either fixed, or z(1-z)sqrt(t).
+		 */
 		double alphas_scale(double t, double z) const;
+
+		/** alpha_s/(2 pi) of an emission, at its scale from alphas_scale()
+		 *  but never below the shower cutoff.
+		 */
 		double alphas_actual(double t, double z) const;
+
+		/** Upper bound on alphas_actual() for emissions whose scale is at
+		 *  least @a scale GeV. With a fixed scale the two are equal, so
+		 *  the alpha_s veto always passes.
+		 */
 		double alphas_over(double scale) const;
 
 	private:
-		double calc_alphas_LO(double t) const;
-		double calc_alphas_NLO(double t) const;
+		inline FlavourRegion const& region(double t) const
+		{
+			return _regions[(t >= C_MASS_2) + (t >= B_MASS_2)];
+		}
+
+		double calc_alphas(FlavourRegion const& r, double t) const;
+		double calc_alphas_LO(FlavourRegion const& r, double t) const;
+		double calc_alphas_NLO(FlavourRegion const& r, double t) const;
+
+		void fill_table(FlavourRegion& r, double t_lo, double t_hi);
+
+		/** Evaluates the cubic of the interval containing @a t.
+		 *  Stepping through the table by the bit pattern of t
+		 *  needs neither a logarithm nor a division to find the interval.
+		 */
+		inline double lookup(FlavourRegion const& r, double t) const
+		{
+			uint64_t offset = std::bit_cast<uint64_t>(t) - r.first_bits;
+			std::array<double, 4> const& c = r.inv_alphas[offset >> TABLE_SHIFT];
+			double u = static_cast<double>(offset & ((uint64_t{1} << TABLE_SHIFT) - 1)) * (1.0/(uint64_t{1} << TABLE_SHIFT));
+			return 1.0/(c[0] + u*(c[1] + u*(c[2] + u*c[3])));
+		}
 	};
 };
 
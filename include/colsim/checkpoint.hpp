@@ -0,0 +1,131 @@
+#ifndef __CHECKPOINT_HPP
+#define __CHECKPOINT_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "colsim/common.hpp"
+#include "colsim/emission_store.hpp"
+#include "colsim/event.hpp"
+#include "colsim/particle.hpp"
+#include "colsim/random.hpp"
+
+namespace colsim
+{
+	template <typename T>
+	concept Checkpointable = std::is_trivially_copyable_v<T>;
+
+
+	/** Writes the state of a run to a checkpoint file. Values are stored
+	 *  as their bytes, so a checkpoint is read back with CheckpointReader
+	 *  in the same order, on the same kind of machine.
+	 *  By default everything goes to a temporary file first, and only
+	 *  commit() puts it in place of the previous checkpoint, so a job
+	 *  killed while writing leaves the last complete checkpoint behind.
+	 *  With APPEND, it is added to the end of the file instead, and
+	 *  whoever reads it back must know where the file ended when
+	 *  it was last committed.
+	 */
+	class CheckpointWriter
+	{
+	public:
+		static constexpr uint64_t MAGIC = 0x54504B434D49534C; // "LSIMCKPT"
+		static constexpr uint32_t VERSION = 3;
+
+		enum Mode
+		{
+			REPLACE,
+			APPEND
+		};
+
+	private:
+		std::string _path, _tmp_path;
+		Mode _mode;
+		std::ofstream _out;
+
+	public:
+		CheckpointWriter(std::string const& path, Mode mode=REPLACE);
+		~CheckpointWriter() = default;
+
+		template <Checkpointable T>
+		inline void write(T const& value)
+		{
+			_out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+
+		/** Writes the length of @a values followed by the values.
+		 */
+		template <Checkpointable T>
+		inline void write(std::span<const T> values)
+		{
+			write<uint64_t>(values.size());
+			_out.write(reinterpret_cast<char const*>(values.data()), values.size_bytes());
+		}
+		template <Checkpointable T>
+		inline void write(std::vector<T> const& values) { write(std::span<const T>(values)); }
+
+		void write(std::string const& str);
+		void write(Random const& rng);
+		void write(Particle const& particle);
+		void write(Event const& event);
+		void write(EmissionStore const& store);
+
+		/** Finishes the file and moves it into place.
+		 *  Returns its size in bytes.
+		 */
+		uint64_t commit();
+	};
+
+
+	/** Reads a checkpoint file written by CheckpointWriter.
+	 *  A file that ends early or was written by another version
+	 *  of the program is an error.
+	 */
+	class CheckpointReader
+	{
+	private:
+		std::string _path;
+		std::ifstream _in;
+
+	public:
+		CheckpointReader(std::string const& path);
+		~CheckpointReader() = default;
+
+		template <Checkpointable T>
+		inline T read()
+		{
+			T value;
+			_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			check();
+			return value;
+		}
+
+		template <Checkpointable T>
+		inline void read(std::vector<T>& values)
+		{
+			values.resize(read<uint64_t>());
+			_in.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(T));
+			check();
+		}
+
+		/** Bytes read so far, header included.
+		 */
+		inline uint64_t position() { return static_cast<uint64_t>(_in.tellg()); }
+
+		std::string read_string();
+		Random read_random();
+		Particle read_particle();
+		Event read_event();
+		void read(EmissionStore& store);
+
+	private:
+		void check();
+	};
+}; // namespace colsim
+
+
+#endif // __CHECKPOINT_HPP
@@ -3,10 +3,16 @@
 
 #include <memory>
 
+#include "colsim/checkpoint.hpp"
 #include "colsim/common.hpp"
+#include "colsim/emission_store.hpp"
 #include "colsim/hard_process.hpp"
+#include "colsim/metrics.hpp"
 #include "colsim/parton_shower.hpp"
-#include "colsim/settings.hpp"
+#include "colsim/random.hpp"
+#include "colsim/run_result.hpp"
+#include "colsim/run_config.hpp"
+#include "colsim/shower_kinematics.hpp"
 #include "colsim/utils.hpp"
 #include "colsim/event.hpp"
 
@@ -18,26 +24,77 @@ namespace colsim
 		enum InitFlag
 		{
 			HARD_SCATTERING,
-			PARTON_SHOWERING
+			PARTON_SHOWERING,
+			// hard scattering with every coloured parton
+			// of each event showered from the event's scale
+			FULL
 		};
+
+		// bins of the histograms in a run result
+		static constexpr uint HISTOGRAM_BINS = 100;
+
+		// in the full mode, hard events are handed to the
+		// shower threads in chunks of this many
+		static constexpr uint PIPELINE_CHUNK_SIZE = 256;
+		// and at most this many chunks per shower thread wait in the queue
+		static constexpr uint PIPELINE_QUEUE_DEPTH = 2;
 		
 	private:
 		InitFlag flag;
+
+		// the configuration of this run, handed on to everything it makes
+		RunConfig _config{};
 		
 		std::unique_ptr<HardProcess> _hard_process;
 		std::unique_ptr<PartonShower> _parton_shower;
 
+		// every random number of a run comes from here, seeded by @a Seed,
+		// on the stream of the shard that this run is
+		Random _rng{};
+
 		// values set after cross section calculation
-		double _xs, _xs_error;
-		double _max_weight;
+		double _xs{0.0}, _xs_error{0.0};
+		double _max_weight{0.0};
 		std::vector<double> _max_ps_points;
 
+		// how far the run has got, which is what a checkpoint records
+		enum class RunStage : uint8_t
+		{
+			INTEGRATION,
+			GENERATION
+		};
+		RunStage _stage{RunStage::INTEGRATION};
+		IntegrationState _integration{};
+		uint _events_requested{0}, _events_done{0};
+		// set when the run continues from a checkpoint,
+		// until the interrupted generate_events() is continued
+		bool _resumed{false};
+
+		// how much of each record is in the checkpoint's record file,
+		// which only ever has the records added since appended to it;
+		// a size of 0 has the next checkpoint start the file over
+		struct CheckpointedRecords
+		{
+			uint64_t events, plot_points, showers, particles, final_states;
+			uint64_t file_size;
+		};
+		CheckpointedRecords _checkpointed{};
+
 		// the main event/emission records
 		std::vector<Event> _event_record;
-		std::vector<std::vector<PartonShower::Emission>> _emission_record;
+		EmissionStore _emission_record;
+
+		// final states of the showered events, event i occupying
+		// [offsets[i], offsets[i+1]) of the particles
+		ShowerKinematics _kinematics{};
+		std::vector<Particle> _final_particles{};
+		std::vector<uint> _final_offsets{0};
 		
 		// list of plot points for generating plots
 		 std::vector<std::vector<double>> _plot_points;
+
+		// the metrics when init() was called
+		Metrics _metrics_start{};
 		
 	public:
 		ColSimMain(std::string const& log_file_path="out.log");
@@ -48,6 +105,19 @@ namespace colsim
 		 */
 	    void init(InitFlag initFlag, std::string const& config_file_path="");
 
+		/** As above, with a configuration that was already loaded,
+		 *  and possibly changed, e.g. by @a RunConfig::load().
+		 */
+		void init(InitFlag initFlag, RunConfig const& config);
+
+		inline RunConfig const& config() const { return _config; }
+
+		/** Counters and timers of everything done since init(), by any
+		 *  thread, so runs going on at the same time are counted together.
+		 *  With @a MetricsFile set, stop() writes them out as JSON.
+		 */
+		inline Metrics metrics() const { return Metrics::collect() - _metrics_start; }
+
 		/** Calculates the cross section and does a few more initialization
 		 *  steps in preparation for event generation.
 		 */
@@ -58,6 +128,10 @@ namespace colsim
 		bool generate_event();
 
 		/** Generates @a numEvents events and stores them in the event record.
+		 *  With @a CheckpointFile set, this is done @a CheckpointInterval
+		 *  events at a time with a checkpoint after each, and a run that
+		 *  was resumed from a checkpoint continues the events it was
+		 *  generating when it stopped.
 		 */
 		void generate_events(uint numEvents);
 
@@ -76,9 +150,17 @@ namespace colsim
 
 
 		/** Finalizes event generation and consolidates the event record.
+		 *  The run result is written to @a ResultFile, if one is set,
+		 *  and the checkpoint of the run, now complete, is removed.
 		 */
 		void stop();
 
+		/** Sums of the integration, generation counters and histograms
+		 *  of the events generated, in a form that the results of the
+		 *  shards of a run can be merged from.
+		 */
+		RunResult run_result() const;
+
 
 		/** Simple getters for the cross section and cross section errors.
 		 */
@@ -86,8 +168,36 @@ namespace colsim
 		inline double cross_section_error() const { return _xs_error; }
 
 		
+		/** Recomputes the weight of every event in the event record
+		 *  for the electroweak parameters @a ew. This needs the events
+		 *  to have been generated with @a StoreMEComponents enabled.
+		 */
+		std::vector<double> reweight(ElectroweakParams const& ew) const;
+
+		/** Cross section for the electroweak parameters @a ew,
+		 *  estimated by reweighting the event record.
+		 */
+		double reweighted_cross_section(ElectroweakParams const& ew) const;
+
 		inline std::vector<std::vector<double>> const& plot_points() const { return _plot_points; }
-		inline std::vector<std::vector<PartonShower::Emission>> const& emission_record() const { return _emission_record; }
+
+		/** Emissions of every shower generated, one shower per event;
+		 *  @a emission_record()[i] gives the emissions of the i-th.
+		 */
+		inline EmissionStore const& emission_record() const { return _emission_record; }
+
+		/** Number of showered events with a final state, in the full mode.
+		 */
+		inline uint num_final_states() const { return _final_offsets.size() - 1; }
+
+		/** Final state of the @a i-th showered event, its coloured partons
+		 *  replaced by their showers with momentum conserved overall.
+		 *  Empty if the showers could not be fitted into the event.
+		 */
+		inline std::span<const Particle> final_state(uint i) const
+		{
+			return std::span<const Particle>(_final_particles).subspan(_final_offsets[i], _final_offsets[i+1] - _final_offsets[i]);
+		}
 		
 	private:		
 		/** Helper function to load the corresponding hard process.
@@ -123,6 +233,20 @@ namespace colsim
 		 */
 		bool generate_event_parton_shower();
 
+		/** Overestimate of alpha_s used throughout the shower,
+		 *  taken at the scale set by @a FixedScale. With a running scale
+		 *  this is alpha_s at the cutoff: z(1-z)sqrt(t) falls to the cutoff
+		 *  at the edges of the z-range at every t, so no bound constant in z
+		 *  is any lower. A tighter one would have to depend on z, which the
+		 *  closed-form emission scale solve does not allow for.
+		 */
+		double shower_alphas_over() const;
+
+		/** Logs how many trial emissions of the shower were accepted,
+		 *  and the region of (t, z) where the fewest were.
+		 */
+		void log_veto_stats() const;
+
 		/** Internal function called from @a generatePlots()
 		 *  if the user passed in the @a HARD_PROCESS
 		 *  initialization flag.
@@ -135,6 +259,57 @@ namespace colsim
 		 */
 		void generate_plots_parton_shower();
 
+		/** Generates @a num_events more events in the mode of the run.
+		 */
+		void generate_events_batch(uint num_events);
+
+		inline bool checkpointing() const { return !_config.checkpoint_file.empty(); }
+
+		/** Saves everything needed to continue the run to @a CheckpointFile:
+		 *  the random number stream, the integration sums, the state
+		 *  of the hard process and all records generated so far.
+		 *  The records go to a file of their own, next to it.
+		 */
+		void write_checkpoint();
+
+		/** Appends the records added since the last checkpoint
+		 *  to the record file of the checkpoint.
+		 */
+		void append_checkpoint_records();
+
+		/** Restores the run from @a CheckpointFile, which must
+		 *  have been written with the same settings.
+		 */
+		void read_checkpoint();
+
+		/** Reads the records of the checkpoint back, dropping
+		 *  whatever was appended after it was written.
+		 */
+		void read_checkpoint_records();
+
+		inline std::string checkpoint_records_file() const { return _config.checkpoint_file + ".records"; }
+
+		/** Internal function called from @a generateEvent()
+		 *  if the user passed in the @a FULL initialization flag.
+		 */
+		bool generate_event_full();
+
+		/** Generates @a num_events full events as a pipeline: this thread
+		 *  produces hard events while the other threads shower them.
+		 */
+		void generate_events_full(uint num_events);
+
+		/** Gives @a event one shower per outgoing coloured parton, numbered
+		 *  from @a first in the emission record, and appends the starting
+		 *  scale and kind of each to @a scales and @a kinds. Returns their number.
+		 */
+		uint assign_showers(Event& event, uint first, std::vector<double>& scales, std::vector<PartonKind>& kinds);
+
+		/** Builds the final state of each event from @a first_event onwards
+		 *  out of its showers, logging how many could not be.
+		 */
+		void reconstruct_final_states(uint first_event);
+
 	};
 	
 }; // namespace ColSim;
@@ -1,7 +1,9 @@
 #ifndef __COMMON_HPP
 #define __COMMON_HPP
 
+#include <algorithm>
 #include <filesystem>
+#include <vector>
 
 #define COLSIM_JOIN0(a, b) a ## b
 #define COLSIM_JOIN(a, b) COLSIM_JOIN0(a, b)
@@ -20,6 +22,18 @@ namespace colsim
 
     using uint = unsigned;
 
+	/** Makes room for @a n more elements at the end of @a v. Unlike
+	 *  reserve() on its own, which grows to exactly the size asked for,
+	 *  the capacity at least doubles, so that calling this before
+	 *  every append does not copy the whole vector every time.
+	 */
+	template <typename T>
+	inline void reserve_more(std::vector<T>& v, size_t n)
+	{
+		if (v.capacity() - v.size() < n)
+			v.reserve(std::max(v.size() + n, 2*v.capacity()));
+	}
+
     // group theoretical constants
     constexpr double NC = 3.0;
     constexpr double TR = (1.0/2.0);
@@ -0,0 +1,81 @@
+#ifndef __CONCURRENCY_HPP
+#define __CONCURRENCY_HPP
+
+#include "colsim/common.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace colsim
+{
+	/** First-in first-out queue shared between producer and consumer
+	 *  threads. It holds at most @a capacity items, so a producer that
+	 *  runs ahead blocks instead of piling up work in memory.
+	 */
+	template <typename T>
+	class BoundedQueue
+	{
+	private:
+		std::deque<T> _items{};
+		uint _capacity;
+		bool _closed{false};
+
+		std::mutex _mutex{};
+		std::condition_variable _not_full{}, _not_empty{};
+
+	public:
+		BoundedQueue(uint capacity) : _capacity{capacity} {}
+		~BoundedQueue() = default;
+
+		/** Adds @a item, waiting for space if the queue is full.
+		 *  Returns false, dropping the item, if the queue has been closed.
+		 */
+		bool push(T item)
+		{
+			std::unique_lock lock(_mutex);
+			_not_full.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+			if (_closed)
+				return false;
+
+			_items.push_back(std::move(item));
+			lock.unlock();
+			_not_empty.notify_one();
+			return true;
+		}
+
+		/** Takes the oldest item, waiting for one if the queue is empty.
+		 *  Returns nothing once the queue is closed and drained.
+		 */
+		std::optional<T> pop()
+		{
+			std::unique_lock lock(_mutex);
+			_not_empty.wait(lock, [this] { return _closed || !_items.empty(); });
+			if (_items.empty())
+				return std::nullopt;
+
+			T item = std::move(_items.front());
+			_items.pop_front();
+			lock.unlock();
+			_not_full.notify_one();
+			return item;
+		}
+
+		/** Signals that nothing more will be pushed. Consumers
+		 *  still receive whatever is left in the queue.
+		 */
+		void close()
+		{
+			{
+				std::lock_guard lock(_mutex);
+				_closed = true;
+			}
+			_not_full.notify_all();
+			_not_empty.notify_all();
+		}
+	};
+}; // namespace colsim
+
+
+#endif // __CONCURRENCY_HPP
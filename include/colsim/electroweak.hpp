@@ -0,0 +1,61 @@
+#ifndef __ELECTROWEAK_HPP
+#define __ELECTROWEAK_HPP
+
+#include <array>
+
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	/** Electroweak input parameters entering the Drell-Yan matrix element.
+	 *  The defaults are the constants found in common.hpp.
+	 */
+	struct ElectroweakParams
+	{
+		double sin2_theta_w{WEINBERG_ANGLE};
+		double z_mass{Z_MASS};
+		double z_width{Z_WIDTH};
+	};
+
+
+	/** Photon, photon-Z interference and pure Z pieces of a Drell-Yan weight.
+	 */
+	struct DrellYanTerms
+	{
+		double gamma, interference, z;
+
+		inline double total() const { return gamma + interference + z; }
+	};
+
+
+	/** Everything about a single PP2Zg2ll weight which does not depend
+	 *  on the electroweak parameters. The luminosities are indexed by quark
+	 *  type (0 for up-type, 1 for down-type); @a lumi_fwd has the quark
+	 *  coming from the first proton and @a lumi_bwd the antiquark.
+	 *  @a terms holds the weight split as it was at generation time.
+	 */
+	struct DrellYanComponents
+	{
+		double s_hat;
+		double cos_theta;
+		double prefactor; // jacobian and phase space factors
+		std::array<double, 2> lumi_fwd, lumi_bwd;
+		DrellYanTerms terms;
+	};
+
+
+	/** Recomputes the weight of a stored PP2Zg2ll point for
+	 *  the parameters @a ew. No PDFs or phase space are involved,
+	 *  so this is cheap enough to be called for every event in a scan.
+	 */
+	DrellYanTerms drell_yan_terms(DrellYanComponents const& components, ElectroweakParams const& ew);
+
+	inline double drell_yan_weight(DrellYanComponents const& components, ElectroweakParams const& ew)
+	{
+		return drell_yan_terms(components, ew).total();
+	}
+
+}; // namespace colsim
+
+
+#endif // __ELECTROWEAK_HPP
@@ -0,0 +1,99 @@
+#ifndef __EMISSION_STORE_HPP
+#define __EMISSION_STORE_HPP
+
+#include "colsim/common.hpp"
+
+#include <span>
+#include <vector>
+
+namespace colsim
+{
+	/** A single accepted emission of a parton shower.
+	 */
+	struct Emission
+	{
+		double t;    // evolution scale
+		double z;    // momentum fraction kept by the emitter
+		double pT_2; // transverse momentum squared
+		double m_2;  // virtual mass squared of the emitter
+		int pid;     // emitted parton: a gluon, or the antiquark of g->qqbar
+	};
+
+
+	/** Emissions of many showers kept in one contiguous array,
+	 *  with shower i occupying [offsets[i], offsets[i+1]).
+	 *  Adding a shower only ever appends, so a store that is cleared
+	 *  and refilled stops allocating once it has grown large enough.
+	 */
+	class EmissionStore
+	{
+	private:
+		std::vector<Emission> _emissions{};
+		std::vector<uint> _offsets{0};
+
+	public:
+		EmissionStore() = default;
+		~EmissionStore() = default;
+
+		inline uint num_showers() const { return _offsets.size() - 1; }
+		inline uint num_emissions() const { return _emissions.size(); }
+		inline bool empty() const { return num_showers() == 0; }
+
+		/** Removes all showers while keeping the allocated memory.
+		 */
+		inline void clear()
+		{
+			_emissions.clear();
+			_offsets.resize(1);
+		}
+
+		/** Makes room for @a num_showers showers with @a num_emissions
+		 *  emissions in all, growing as reserve_more() does.
+		 */
+		inline void reserve(uint num_showers, uint num_emissions)
+		{
+			reserve_more(_offsets, (num_showers + 1) - std::min<size_t>(num_showers + 1, _offsets.size()));
+			reserve_more(_emissions, num_emissions - std::min<size_t>(num_emissions, _emissions.size()));
+		}
+
+		/** Emissions of shower @a i, in the order they were generated.
+		 */
+		inline std::span<const Emission> shower(uint i) const
+		{
+			return std::span<const Emission>(_emissions).subspan(_offsets[i], _offsets[i+1] - _offsets[i]);
+		}
+		inline std::span<const Emission> operator[](uint i) const { return shower(i); }
+
+		/** Every emission of every shower, e.g. for filling histograms.
+		 */
+		inline std::span<const Emission> emissions() const { return _emissions; }
+		inline std::span<const uint> offsets() const { return _offsets; }
+
+		/** Appends an emission to the shower currently being built,
+		 *  which becomes a shower of its own on @a close_shower().
+		 */
+		inline void push_back(Emission const& e) { _emissions.push_back(e); }
+		inline void close_shower() { _offsets.push_back(_emissions.size()); }
+
+		/** Appends a whole shower at once.
+		 */
+		inline void add_shower(std::span<const Emission> emissions)
+		{
+			_emissions.insert(_emissions.end(), emissions.begin(), emissions.end());
+			close_shower();
+		}
+
+		/** Appends every shower of @a other, keeping their order.
+		 */
+		inline void append(EmissionStore const& other)
+		{
+			uint base = _emissions.size();
+			_emissions.insert(_emissions.end(), other._emissions.begin(), other._emissions.end());
+			for (uint i=1; i<other._offsets.size(); i++)
+				_offsets.push_back(base + other._offsets[i]);
+		}
+	};
+}; // namespace colsim
+
+
+#endif // __EMISSION_STORE_HPP
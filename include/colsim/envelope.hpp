@@ -0,0 +1,174 @@
+#ifndef __ENVELOPE_HPP
+#define __ENVELOPE_HPP
+
+#include "colsim/checkpoint.hpp"
+#include "colsim/common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace colsim
+{
+	/** Tabulated upper bound of the weight over a regular grid of
+	 *  @a N dimensional phase space cells. It is filled with the weights
+	 *  seen during integration, so that generation can reject most
+	 *  candidates from their cell alone, before any PDFs are needed.
+	 */
+	template <uint N>
+	class WeightEnvelope
+	{
+	public:
+		using point_type = std::array<double, N>;
+
+		// the tabulated maxima are only estimates of the true
+		// maxima, so they are inflated by this much
+		static constexpr double SAFETY_FACTOR = 1.5;
+		// lowest bound of any cell, relative to the global maximum,
+		// so that no part of phase space is shut off entirely
+		static constexpr double MIN_FRACTION = 1e-6;
+		// aim for at least this many samples per cell
+		static constexpr uint SAMPLES_PER_CELL = 100;
+		static constexpr uint MAX_BINS = 32;
+
+	private:
+		uint _bins{0};
+		point_type _min{}, _inv_width{};
+		std::vector<double> _bounds{};
+		std::vector<uint> _counts{};
+
+	public:
+		WeightEnvelope() = default;
+		~WeightEnvelope() = default;
+
+		inline bool empty() const { return _bounds.empty(); }
+		inline uint bins() const { return _bins; }
+		inline uint num_cells() const { return _bounds.size(); }
+
+		/** Sets up an empty grid over the box starting at @a mins with
+		 *  sides @a deltas, sized for @a num_samples integration samples.
+		 */
+		void reset(point_type const& mins, point_type const& deltas, uint num_samples)
+		{
+			double per_dim = std::pow(static_cast<double>(num_samples)/SAMPLES_PER_CELL, 1.0/N);
+			_bins = std::clamp(static_cast<uint>(per_dim), 1u, MAX_BINS);
+
+			uint num_cells = 1;
+			for (uint i=0; i<N; i++) {
+				_min[i] = mins[i];
+				_inv_width[i] = _bins/deltas[i];
+				num_cells *= _bins;
+			}
+			_bounds.assign(num_cells, 0.0);
+			_counts.assign(num_cells, 0);
+		}
+
+		/** Index of the cell containing @a point.
+		 */
+		inline uint cell(point_type const& point) const
+		{
+			uint index = 0;
+			for (uint i=0; i<N; i++) {
+				int bin = static_cast<int>((point[i] - _min[i])*_inv_width[i]);
+				bin = std::clamp(bin, 0, static_cast<int>(_bins) - 1);
+				index = index*_bins + static_cast<uint>(bin);
+			}
+			return index;
+		}
+
+		/** Records a weight seen at @a point during integration.
+		 */
+		inline void fill(point_type const& point, double weight)
+		{
+			uint c = cell(point);
+			_counts[c]++;
+			if (weight > _bounds[c])
+				_bounds[c] = weight;
+		}
+
+		/** Turns the recorded maxima into the envelope. Each cell takes the
+		 *  largest maximum of itself and its direct neighbours times the
+		 *  safety factor, and nothing is allowed above @a max_weight.
+		 *  Cells which were never sampled get @a max_weight.
+		 */
+		void finalize(double max_weight)
+		{
+			std::vector<double> bounds(_bounds.size(), 0.0);
+			std::array<int, N> index;
+
+			for (uint c=0; c<_bounds.size(); c++) {
+				if (_counts[c] == 0) {
+					bounds[c] = max_weight;
+					continue;
+				}
+
+				// unravel the index of this cell
+				uint rest = c;
+				for (int i=N-1; i>=0; i--) {
+					index[i] = rest % _bins;
+					rest /= _bins;
+				}
+
+				// walk over the 3^N block around it
+				double neighbour_max = 0.0;
+				uint num_neighbours = 1;
+				for (uint i=0; i<N; i++)
+					num_neighbours *= 3;
+				for (uint n=0; n<num_neighbours; n++) {
+					uint offsets = n;
+					uint neighbour = 0;
+					bool inside = true;
+					for (uint i=0; i<N; i++) {
+						int bin = index[i] + static_cast<int>(offsets % 3) - 1;
+						offsets /= 3;
+						if (bin < 0 || bin >= static_cast<int>(_bins)) {
+							inside = false;
+							break;
+						}
+						neighbour = neighbour*_bins + static_cast<uint>(bin);
+					}
+					if (inside)
+						neighbour_max = std::max(neighbour_max, _bounds[neighbour]);
+				}
+
+				bounds[c] = std::clamp(SAFETY_FACTOR*neighbour_max, MIN_FRACTION*max_weight, max_weight);
+			}
+
+			_bounds = std::move(bounds);
+		}
+
+		inline double bound(uint cell) const { return _bounds[cell]; }
+
+		/** Raises the bound of @a cell after it was found to be
+		 *  exceeded by @a weight, never going above @a max_weight.
+		 */
+		inline void raise(uint cell, double weight, double max_weight)
+		{
+			_bounds[cell] = std::max(_bounds[cell], std::min(SAFETY_FACTOR*weight, max_weight));
+		}
+
+		/** Writes the grid and the bounds recorded so far to @a out.
+		 */
+		void save(CheckpointWriter& out) const
+		{
+			out.write(_bins);
+			out.write(_min);
+			out.write(_inv_width);
+			out.write(_bounds);
+			out.write(_counts);
+		}
+
+		void load(CheckpointReader& in)
+		{
+			_bins = in.read<uint>();
+			_min = in.read<point_type>();
+			_inv_width = in.read<point_type>();
+			in.read(_bounds);
+			in.read(_counts);
+		}
+	};
+}; // namespace colsim
+
+
+#endif // __ENVELOPE_HPP
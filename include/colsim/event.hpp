@@ -2,9 +2,11 @@
 #define __EVENT_HPP
 
 #include "colsim/particle.hpp"
+#include "colsim/electroweak.hpp"
 
 #include <vector>
 #include <format>
+#include <optional>
 
 namespace colsim
 {
@@ -14,6 +16,10 @@ namespace colsim
 		double _weight;
 		std::vector<Particle> _particles{};
 		double _Q, _cos_theta, _y;
+		std::optional<DrellYanComponents> _components{};
+
+		// showers of the coloured partons, as indices into the emission record
+		uint _first_shower{0}, _num_showers{0};
 		
 	public:
 		Event(double w, std::vector<Particle> const& p, double Q=0, double cos_theta=0, double y=0)
@@ -24,10 +30,23 @@ namespace colsim
 		{}
 
 		inline double weight() const { return _weight; }
+		// the hard scale of the event, where its showers start
 		inline double Q() const { return _Q; }
 		inline double cos_theta() const { return _cos_theta; }
 		inline double y() const { return _y; }
 		inline std::vector<Particle> const& particles() const { return _particles; }
+
+		/** Matrix element components stored for reweighting, if requested.
+		 */
+		inline std::optional<DrellYanComponents> const& components() const { return _components; }
+		inline void set_components(DrellYanComponents const& c) { _components = c; }
+
+		/** Showers of the event's coloured partons, which are
+		 *  @a first_shower() onwards in the emission record.
+		 */
+		inline uint first_shower() const { return _first_shower; }
+		inline uint num_showers() const { return _num_showers; }
+		inline void set_showers(uint first, uint count) { _first_shower = first; _num_showers = count; }
 	};
 
 	// I am so lazy lmao
@@ -40,17 +40,67 @@ namespace colsim
 		inline double pt_2() const { return _data[1]*_data[1] + _data[2]*_data[2]; }
 		inline double pt() const { return std::sqrt(pt_2()); }
 
+		// squared length of the three-momentum
+		inline double p_2() const { return pt_2() + _data[3]*_data[3]; }
+		inline double p() const { return std::sqrt(p_2()); }
+		// invariant mass squared, which can come out slightly negative for massless vectors
+		inline double m_2() const { return _data[0]*_data[0] - p_2(); }
+
+		inline FourVector& operator+=(FourVector const& other) {
+			for (uint i=0; i<4; i++)
+				_data[i] += other._data[i];
+			return *this;
+		}
+		inline FourVector& operator*=(double a) {
+			for (double& x : _data)
+				x *= a;
+			return *this;
+		}
+		inline friend FourVector operator+(FourVector a, FourVector const& b) { return a += b; }
+		inline friend FourVector operator*(double a, FourVector v) { return v *= a; }
+
 		inline FourVector& zboost(double beta) {
-			double gamma = std::sqrt(1.0F / (1.0F - pow(beta, 2)));
+			double gamma = std::sqrt(1.0 / (1.0 - beta*beta));
 			// store these to avoid modifying while computing
 			double e = _data[0];
 			double pz = _data[3];
 
 			_data[0] = gamma * e - gamma * beta * pz;
-			_data[1] = -gamma * beta * e + gamma * pz;
+			_data[3] = -gamma * beta * e + gamma * pz;
 
 			return *this;
 		}
+
+		/** Boosts into the frame moving with velocity (@a bx, @a by, @a bz),
+		 *  the general version of zboost().
+		 */
+		inline FourVector& boost(double bx, double by, double bz) {
+			double beta_2 = bx*bx + by*by + bz*bz;
+			if (beta_2 == 0.0)
+				return *this;
+			double gamma = 1.0 / std::sqrt(1.0 - beta_2);
+			double bp = bx*_data[1] + by*_data[2] + bz*_data[3];
+			double a = (gamma - 1.0)*bp/beta_2 - gamma*_data[0];
+
+			_data[0] = gamma*(_data[0] - bp);
+			_data[1] += a*bx;
+			_data[2] += a*by;
+			_data[3] += a*bz;
+
+			return *this;
+		}
+
+		/** Boosts into the rest frame of @a frame.
+		 */
+		inline FourVector& boost_to_rest(FourVector const& frame) {
+			return boost(frame.px()/frame.e(), frame.py()/frame.e(), frame.pz()/frame.e());
+		}
+
+		/** Boosts out of the rest frame of @a frame, the inverse of boost_to_rest().
+		 */
+		inline FourVector& boost_from_rest(FourVector const& frame) {
+			return boost(-frame.px()/frame.e(), -frame.py()/frame.e(), -frame.pz()/frame.e());
+		}
 	};
 }; // namespace colsim
 
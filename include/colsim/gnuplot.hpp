@@ -136,7 +136,7 @@ namespace colsim
 			if (output_file_type == AUTO) {
 				std::string::size_type dot_pos = file_name.find(".");
 				if (dot_pos == std::string::npos)
-					log(LOG_ERROR, "Plotter::setOutputFile()", "Failed to deduce type of output file {}", file_name);
+					COLSIM_LOG(LOG_ERROR, "Plotter::setOutputFile()", "Failed to deduce type of output file {}", file_name);
 
 				std::string ext = file_name.substr(dot_pos + 1);
 
@@ -146,7 +146,7 @@ namespace colsim
 				} else if (ext.compare("png") == 0) {
 					output_file_type = PNG;
 				} else {
-					log(LOG_ERROR, "Plotter::setOutputFile()", "File extension '{}' isn't recognized.", ext);
+					COLSIM_LOG(LOG_ERROR, "Plotter::setOutputFile()", "File extension '{}' isn't recognized.", ext);
 				}
 			}
 
@@ -159,12 +159,12 @@ namespace colsim
 		Plotter& plot(std::vector<data_type> const& X, std::vector<data_type> const& y, std::string plot_title="")
 		{
 			if (X.size() != y.size())
-				log(LOG_ERROR, "Plotter::plot()", "X size ({}) and y size ({}) differ.", X.size(), y.size());
+				COLSIM_LOG(LOG_ERROR, "Plotter::plot()", "X size ({}) and y size ({}) differ.", X.size(), y.size());
 
 		    _data_file_path = DATA_DIR;
 			if (!fs::exists(_data_file_path)) {
 				if(!fs::create_directory(_data_file_path))
-					log(LOG_ERROR, "Plotter::plot()", "Failed to create output data directory '{}'.", _data_file_path.string());
+					COLSIM_LOG(LOG_ERROR, "Plotter::plot()", "Failed to create output data directory '{}'.", _data_file_path.string());
 			}
 
 			std::ostringstream data_file_name{};
@@ -173,7 +173,7 @@ namespace colsim
 			_data_file_path /= data_file_name.str();
 			_data_file.open(_data_file_path.make_preferred(), std::ios_base::out);
 			if (!_data_file)
-				log(LOG_ERROR, "Plotter::plot()", "Failed to open file '{}'.", _data_file_path.string());
+				COLSIM_LOG(LOG_ERROR, "Plotter::plot()", "Failed to open file '{}'.", _data_file_path.string());
 
 			for (std::tuple<data_type,data_type> x : std::ranges::zip_view{X, y})
 				_data_file << std::get<0>(x) << '\t' << std::get<1>(x) << '\n';
@@ -192,21 +192,21 @@ namespace colsim
 			_script_file_path = SCRIPT_DIR;
 			if (!fs::exists(_script_file_path)) {
 				if (!fs::create_directory(_script_file_path))
-					log(LOG_ERROR, "Plotter::plot()", "Failed to create script output directory.");
+					COLSIM_LOG(LOG_ERROR, "Plotter::plot()", "Failed to create script output directory.");
 			}
 
 			_script_file_name = "script.gplt";
 			_script_file_path /= _script_file_name;
 			_script_file.open(_script_file_path);
 			if (!_script_file)
-				log(LOG_ERROR, "Plotter::save()", "Failed to open the script file '{}'.", _script_file_path.string());
+				COLSIM_LOG(LOG_ERROR, "Plotter::save()", "Failed to open the script file '{}'.", _script_file_path.string());
 
 			std::string terminal_type{};
 			switch (_output_file_type) {
 				case PNG: terminal_type = "pngcairo"; break;
 				case PDF: terminal_type = "pdfcairo"; break;
 				case AUTO:
-				default: log(LOG_ERROR, "Plotter::save()", "Invalid output file/terminal type.");
+				default: COLSIM_LOG(LOG_ERROR, "Plotter::save()", "Invalid output file/terminal type.");
 			}
 
 			_script_file << "set terminal " << terminal_type << " enhanced notransparent\n";
@@ -246,10 +246,10 @@ namespace colsim
 
 			std::ostringstream command{};
 			command << "gnuplot " << _script_file_path.string();
-			log(LOG_INFO, "Plotter::save()", "the command is {}", command.str());
+			COLSIM_LOG(LOG_INFO, "Plotter::save()", "the command is {}", command.str());
 
 			if (system(command.str().c_str()) != 0)
-				log(LOG_ERROR, "Plotter::save()", "Failed to create child shell to call gnuplot, or gnuplot call failed.");
+				COLSIM_LOG(LOG_ERROR, "Plotter::save()", "Failed to create child shell to call gnuplot, or gnuplot call failed.");
 
 			return *this;
 		}
@@ -259,7 +259,7 @@ namespace colsim
 		inline std::string _genLine_yrange()
 		{
 			if (_ymin >= _ymax)
-				log(LOG_ERROR, "Plotter::_genLine_yrange()", "minimum y value ({}) is equal to or larger than maximum y value ({})", _ymin, _ymax);
+				COLSIM_LOG(LOG_ERROR, "Plotter::_genLine_yrange()", "minimum y value ({}) is equal to or larger than maximum y value ({})", _ymin, _ymax);
 		
 			std::ostringstream ss{};
 			ss << "set yrange [" << _ymin << ":" << _ymax << "]";
@@ -269,7 +269,7 @@ namespace colsim
 		inline std::string _genLine_xrange()
 		{
 			if (_xmin >= _xmax)
-				log(LOG_ERROR, "Plotter::_genLine_xrange()", "minimum x value ({}) is equal to or larger than maximum x value ({})", _xmin, _xmax);
+				COLSIM_LOG(LOG_ERROR, "Plotter::_genLine_xrange()", "minimum x value ({}) is equal to or larger than maximum x value ({})", _xmin, _xmax);
 		
 			std::ostringstream ss{};
 			ss << "set yrange [" << _xmin << ":" << _xmax << "]";
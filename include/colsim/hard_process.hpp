@@ -1,13 +1,26 @@
 #ifndef __HARD_PROCESS_HPP
 #define __HARD_PROCESS_HPP
 
+#include "colsim/checkpoint.hpp"
 #include "colsim/common.hpp"
+#include "colsim/electroweak.hpp"
+#include "colsim/envelope.hpp"
+#include "colsim/event.hpp"
+#include "colsim/math.hpp"
+#include "colsim/metrics.hpp"
 #include "colsim/phase_space.hpp"
 #include "colsim/particle.hpp"
-#include "colsim/settings.hpp"
+#include "colsim/pdf.hpp"
+#include "colsim/run_config.hpp"
 
+#include <array>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
 
 namespace colsim
 {
@@ -22,7 +35,7 @@ namespace colsim
 	struct HardProcessResult
 	{
 		double result, error;
-		double max_weight;
+		double max_weight{0.0};
 		std::vector<double> max_points;
 
 		HardProcessResult() = delete;
@@ -35,24 +48,95 @@ namespace colsim
 	};
 
 
+	/** Running sums of a cross section integration, so that it can
+	 *  be done a batch of iterations at a time and checkpointed between.
+	 */
+	struct IntegrationState
+	{
+		uint64_t iterations{0};
+		double weight_sum{0.0};
+		double weight_squared_sum{0.0};
+		double max_weight{0.0};
+		std::vector<double> max_points{};
+
+		/** Cross section in picobarns and its statistical error.
+		 */
+		inline double result() const
+		{
+			return iterations > 0 ? MAGIC_FACTOR*weight_sum/static_cast<double>(iterations) : 0.0;
+		}
+		inline double error() const
+		{
+			if (iterations == 0)
+				return 0.0;
+			// doing divisions, so we want a Double
+			double num_evals = static_cast<double>(iterations);
+			double variance = weight_squared_sum/num_evals
+				              - std::pow(weight_sum/num_evals,2);
+			return MAGIC_FACTOR*std::sqrt(variance/num_evals);
+		}
+
+		/** Adds the points of the independent integration @a other.
+		 *  The sums simply add, so merging gives the same result as
+		 *  one integration over all the points.
+		 */
+		inline void merge(IntegrationState const& other)
+		{
+			iterations += other.iterations;
+			weight_sum += other.weight_sum;
+			weight_squared_sum += other.weight_squared_sum;
+			if (other.max_weight > max_weight) {
+				max_weight = other.max_weight;
+				max_points = other.max_points;
+			}
+		}
+	};
+
+
+	/** Counters of the hit-or-miss event generation.
+	 */
+	struct GenerationStats
+	{
+		unsigned long candidates{0};   // phase space points drawn
+		unsigned long pre_rejected{0}; // rejected by the envelope alone
+		unsigned long evaluated{0};    // points for which dsigma() was called
+		unsigned long accepted{0};
+		unsigned long violations{0};   // points whose weight exceeded the envelope
+
+		inline double pre_rejection_rate() const {
+			return candidates > 0 ? static_cast<double>(pre_rejected)/static_cast<double>(candidates) : 0.0;
+		}
+	};
+
+
 	/** Base class containing information related to calculation
 	 *  and generation of events pertaining to specific hard processes.
 	 */
 	class HardProcess
 	{
 	protected:
-		/** The underlying phase space object tasked with the random
-		 *  but self-consistent generation of phase space points
-		 *  characteristic for this process
-		 */
-		std::unique_ptr<PhaseSpace> _phase_space;
+		GenerationStats _generation_stats{};
+
+		// what every process needs of the configuration,
+		// kept here rather than looked up in the hot loops
+		double _ecm, _s;
+		std::shared_ptr<const PDFSet> _pdf;
+		uint _num_iterations;
+
+		// PDF lookups made by dsigma() and generate_particles(), which
+		// the loops add to the metrics once per batch rather than per lookup
+		uint64_t _pdf_calls{0};
 
 	public:
-		HardProcess() : _phase_space(nullptr) {}
+		/** Loads the PDF set of @a config, if nothing has yet.
+		 */
+		HardProcess(RunConfig const& config);
 		virtual ~HardProcess() = default;
 
-		PhaseSpace const& get_phase_space() const { return *_phase_space; }
-		PhaseSpace& get_phase_space() { return *_phase_space; }
+		inline GenerationStats const& generation_stats() const { return _generation_stats; }
+
+		virtual PhaseSpaceBase const& get_phase_space() const = 0;
+		virtual PhaseSpaceBase& get_phase_space() = 0;
 
 
 		struct Result
@@ -60,6 +144,13 @@ namespace colsim
 			double weight;
 			std::vector<double> additional_vals;
 
+			// hard scale of the point, which the shower of its partons starts from
+			double scale{0.0};
+
+			// only filled by processes that support reweighting,
+			// and only when asked to
+			std::optional<DrellYanComponents> components{};
+
 			Result(double _weight, std::initializer_list<double> vals = {})
 				: weight{_weight}, additional_vals{vals}
 			{}
@@ -80,70 +171,228 @@ namespace colsim
 			}
 		};
 
-		
-		/** Calculates the differential cross section
-		 *  given an array of phase space points
-		 */
-		virtual Result dsigma(std::vector<double> const& phaseSpacePoints) = 0;
-		
+
 		/** Simulates the hard scattering process and calculates the
-		 *  cross section and max weight values.
+		 *  cross section and max weight values, drawing points from @a rng.
+		 */
+		inline HardProcessResult calculate(Random& rng)
+		{
+			IntegrationState state{};
+			integrate(state, _num_iterations, rng);
+			return finish_integration(state);
+		}
+
+		/** Adds @a num_iterations points to the integration @a state.
+		 *  A state without any iterations starts a new integration.
 		 */
-		HardProcessResult calculate();
+		virtual void integrate(IntegrationState& state, uint num_iterations, Random& rng) = 0;
 
-		/** Generates (4) momenta and places them inside @a momenta. 
+		/** Cross section and maximum weight of the integration @a state,
+		 *  after which the weight envelope is ready for generation.
+		 */
+		virtual HardProcessResult finish_integration(IntegrationState const& state) = 0;
+
+		/** Writes what the process keeps between calls, the weight
+		 *  envelope and the generation statistics, to @a out.
+		 */
+		virtual void save(CheckpointWriter& out) const = 0;
+		virtual void load(CheckpointReader& in) = 0;
+
+		/** Generates @a num_events events via hit-or-miss against @a max_weight
+		 *  and appends them to @a events, along with their phase space points
+		 *  (and additional values) to @a plot_points.
+		 *  All random numbers come from @a rng.
+		 *  Returns the number of events generated.
 		 */
-		virtual void generate_particles(std::vector<Particle>& momenta) = 0;
+		virtual uint generate(uint num_events, double max_weight,
+							  std::vector<Event>& events,
+							  std::vector<std::vector<double>>& plot_points,
+							  Random& rng) = 0;
 	};
 
-	// p + p -> l + l
-	class PP2Zg2ll : public HardProcess
+
+	/** Implements the integration and generation loops of @a HardProcess
+	 *  for the concrete process @a TProcess with phase space @a TPhaseSpace.
+	 *  The loops are instantiated for the concrete types, so that @a dsigma()
+	 *  and the phase space mapping can be inlined; the only virtual call
+	 *  is the one into the loop itself, once per batch.
+	 */
+	template <typename TProcess, typename TPhaseSpace>
+	class HardProcessImpl : public HardProcess
 	{
-    public:
-		PP2Zg2ll();
-		~PP2Zg2ll() = default;
+	public:
+		using phase_space_type = TPhaseSpace;
+		using point_type = typename TPhaseSpace::point_type;
+		static constexpr uint num_dims = TPhaseSpace::num_dims;
+
+	protected:
+		/** The underlying phase space object tasked with the random
+		 *  but self-consistent generation of phase space points
+		 *  characteristic for this process
+		 */
+		TPhaseSpace _phase_space;
+
+		/** Upper bound of the weight per phase space cell, filled
+		 *  during calculate() and used to pre-reject candidates.
+		 */
+		WeightEnvelope<num_dims> _envelope{};
+
+		// the random numbers of this many points are drawn in one go
+		static constexpr uint UNIFORM_BATCH = 64;
+
+		/** Copies of an overweight point that did not fit into the
+		 *  generate() call that accepted it, which the next call
+		 *  emits first, so that no copy is ever dropped.
+		 */
+		struct PendingCopies
+		{
+			point_type points{};
+			double weight{0.0};
+			Result res{0.0};
+			uint copies{0};
+		};
+		PendingCopies _pending{};
+
+	private:
+		/** Appends @a copies events of the point @a points with @a weight to
+		 *  @a events, along with their plot points.
+		 */
+		void emit_copies(uint copies, point_type const& points, double weight, Result const& res,
+						 std::vector<Event>& events, std::vector<std::vector<double>>& plot_points,
+						 Random& rng);
+
+	public:
+		HardProcessImpl(RunConfig const& config)
+			: HardProcess(config), _phase_space(config)
+		{}
+		virtual ~HardProcessImpl() = default;
+
+		PhaseSpaceBase const& get_phase_space() const override { return _phase_space; }
+		PhaseSpaceBase& get_phase_space() override { return _phase_space; }
 
-		Result dsigma(const std::vector<double>& phaseSpacePoints) override;
+		inline TPhaseSpace& phase_space() { return _phase_space; }
+		inline WeightEnvelope<num_dims> const& envelope() const { return _envelope; }
 
-		void generate_particles(std::vector<Particle>& momenta) override;
+		void integrate(IntegrationState& state, uint num_iterations, Random& rng) override;
+		HardProcessResult finish_integration(IntegrationState const& state) override;
+		uint generate(uint num_events, double max_weight,
+					  std::vector<Event>& events,
+					  std::vector<std::vector<double>>& plot_points,
+					  Random& rng) override;
 
+		void save(CheckpointWriter& out) const override
+		{
+			out.write(_generation_stats);
+			_envelope.save(out);
+
+			out.write(_pending.copies);
+			if (_pending.copies == 0)
+				return;
+			out.write(_pending.points);
+			out.write(_pending.weight);
+			out.write(_pending.res.scale);
+			out.write(_pending.res.additional_vals);
+			out.write(_pending.res.components.has_value());
+			if (_pending.res.components)
+				out.write(*_pending.res.components);
+		}
+		void load(CheckpointReader& in) override
+		{
+			_generation_stats = in.read<GenerationStats>();
+			_envelope.load(in);
+
+			_pending = PendingCopies{};
+			_pending.copies = in.read<uint>();
+			if (_pending.copies == 0)
+				return;
+			_pending.points = in.read<point_type>();
+			_pending.weight = in.read<double>();
+			_pending.res.scale = in.read<double>();
+			in.read(_pending.res.additional_vals);
+			if (in.read<bool>())
+				_pending.res.components = in.read<DrellYanComponents>();
+		}
+	};
+
+	// p + p -> l + l
+	class PP2Zg2ll final : public HardProcessImpl<PP2Zg2ll, PhaseSpace_TauYCosth>
+	{
+	public:
+		static constexpr std::string_view name{"PP2Zg2ll"};
+		// the leptons leave nothing for the shower
+		static constexpr bool coloured_final_state = false;
 
 	private:
-		// helpers for calculation of the cross section
-		double kappa() const;
-		double chi1(double s_hat) const;
-		double chi2(double s_hat) const;
-		double a0(uint quarkType, double s_hat) const;
-		double a1(uint quarkType, double s_hat) const;
+		ElectroweakParams _ew{};
+		double _trans_energy_2;
+		bool _store_components;
+
+	public:
+		PP2Zg2ll(RunConfig const& config);
+		~PP2Zg2ll() = default;
+
+		/** Calculates the differential cross section
+		 *  given an array of phase space points
+		 */
+		Result dsigma(std::span<const double, num_dims> phaseSpacePoints);
 
-		/** Computes the partonic cross section.
+		/** Generates (4) momenta for the phase space point
+		 *  @a phaseSpacePoints and places them inside @a momenta. 
 		 */
-		double dsigma_hat(
-			double cosTheta,
-			uint quarkType,
-			double s_hat);
+		void generate_particles(std::span<const double, num_dims> phaseSpacePoints, std::vector<Particle>& momenta, Random& rng);
+
+		inline ElectroweakParams const& electroweak_params() const { return _ew; }
 
-		/** Computes the full weight (i.e. value of integrand).
-		 *  In particular, this function calculates the PDF values.
+		/** Whether @a dsigma() should also hand back the electroweak-independent
+		 *  components of the weight, so that events can be reweighted later.
 		 */
-		double compute_weight(
-			double cosTheta,
-			double x1, double x2,
-			double s_hat);
+		inline void store_components(bool store) { _store_components = store; }
 
+	private:
+		/** Fills the parton luminosities of @a components.
+		 *  This is where all of the PDF calls happen, and are counted.
+		 */
+		void compute_luminosities(DrellYanComponents& components, double x1, double x2);
 	};
 
 
-	class PP2Jets : public HardProcess
+	// p + p -> jet + jet
+	class PP2Jets final : public HardProcessImpl<PP2Jets, PhaseSpace_EtEta>
 	{
+	public:
+		static constexpr std::string_view name{"PP2Jets"};
+		static constexpr bool coloured_final_state = true;
+
 	private:
 		constexpr static double _eta4 = 0.5;
-    public:
-		PP2Jets();
+		constexpr static uint NF = 5; // number of light flavours
+
+		/** Groups of flavour pairs sharing the same
+		 *  partonic cross section (summed over final states).
+		 */
+		enum Channel : uint
+		{
+			QQPRIME = 0, // q + q' and q + qb'
+			QQ,          // q + q
+			QQBAR,       // q + qb
+			GG,          // g + g
+			QG,          // q + g and g + q
+			NUM_CHANNELS
+		};
+
+		// flavours -5..5, with the gluon in place of 0
+		constexpr static uint NUM_FLAVOURS = 2*NF + 1;
+		std::array<std::array<Channel, NUM_FLAVOURS>, NUM_FLAVOURS> _channel_map;
+
+		// buffers for the all-flavour PDF calls, one per proton
+		std::vector<double> _xf1, _xf2;
+
+	public:
+		PP2Jets(RunConfig const& config);
 		~PP2Jets() = default;
 
-		Result dsigma(std::vector<double> const& phaseSpacePoints) override;
-		void generate_particles(std::vector<Particle>& momenta) override;
+		Result dsigma(std::span<const double, num_dims> phaseSpacePoints);
+		void generate_particles(std::span<const double, num_dims> phaseSpacePoints, std::vector<Particle>& momenta, Random& rng);
 
 	private:
 		// some phase space calculations
@@ -156,10 +405,10 @@ namespace colsim
 
 		// compute the momentum fractions from original phase space variables
 		inline double calc_x1(double eta3, double eta4, double E_t) {
-			return (2*E_t / SETTINGS.ecm) * std::cosh(calc_eta_star(eta3, eta4)) * std::exp(calc_eta_bar(eta3, eta4));
+			return (2*E_t / _ecm) * std::cosh(calc_eta_star(eta3, eta4)) * std::exp(calc_eta_bar(eta3, eta4));
 		}
 		inline double calc_x2(double eta3, double eta4, double E_t) {
-			return 2*E_t / SETTINGS.ecm * std::cosh(calc_eta_star(eta3, eta4)) * std::exp(-calc_eta_bar(eta3, eta4));
+			return 2*E_t / _ecm * std::cosh(calc_eta_star(eta3, eta4)) * std::exp(-calc_eta_bar(eta3, eta4));
 		}
 		
 		// s_hat, t_hat, u_hat calculations
@@ -173,16 +422,279 @@ namespace colsim
 			return -calc_sh(eta_star, E_t) - calc_th(eta_star, E_t);
 		}
 
-		// individual calculations of the partonic cross sections
-		double qqprime2qqprime(double eta3, double eta4, double et, double alphas);
-		double qqprimebar2qqprimebar(double eta3, double eta4, double et, double alphas);
-		double qq2qq(double eta3, double eta4, double et, double alphas);
-		double qqbar2qprimeqprimebar(double eta3, double eta4, double et, double alphas);
-		double gg2gg(double eta3, double eta4, double et, double alphas);
-		double qqbar2gg(double eta3, double eta4, double et, double alphas);
-		double gg2qqbar(double eta3, double eta4, double et, double alphas);
-		double qg2qg(double eta3, double eta4, double et, double alphas);
+		/** Partonic cross sections dsigma/dt of every channel,
+		 *  computed once per phase space point.
+		 */
+		std::array<double, NUM_CHANNELS> channel_cross_sections(double s, double t, double u, double alphas) const;
+
+		/** Picks the flavours of the jets of incoming partons @a pid1 and
+		 *  @a pid2, with 0 for the gluon, by the share of each final state
+		 *  in their cross section. The first jet is the one at @a t.
+		 */
+		std::pair<int, int> outgoing_flavours(int pid1, int pid2, double s, double t, double u, Random& rng) const;
+
+		// individual squared matrix elements, in units of pi*alpha_s^2/s^2
+		static double qqprime2qqprime(double s, double t, double u);
+		static double qq2qq(double s, double t, double u);
+		static double qqbar2qqbar(double s, double t, double u);
+		static double qqbar2qprimeqprimebar(double s, double t, double u);
+		static double gg2gg(double s, double t, double u);
+		static double qqbar2gg(double s, double t, double u);
+		static double gg2qqbar(double s, double t, double u);
+		static double qg2qg(double s, double t, double u);
+	};
+
+
+	/** Compile-time list of the available hard processes. Each process
+	 *  provides a static @a name, which is what the 'Process' config key
+	 *  selects, and @a coloured_final_state, whether it produces outgoing
+	 *  partons for the shower; adding a process to the @a Processes alias
+	 *  below is all that is needed to make it selectable.
+	 */
+	template <typename... TProcesses>
+	struct ProcessRegistry
+	{
+		static constexpr std::array<std::string_view, sizeof...(TProcesses)> names{TProcesses::name...};
+
+		static constexpr bool contains(std::string_view name)
+		{
+			return ((name == TProcesses::name) || ...);
+		}
+
+		/** Whether the process named @a name has outgoing partons to shower.
+		 */
+		static constexpr bool has_coloured_final_state(std::string_view name)
+		{
+			return ((name == TProcesses::name && TProcesses::coloured_final_state) || ...);
+		}
+
+		/** Calls @a func with the concrete type of the process named @a name
+		 *  as its template argument. Returns false if no process matched.
+		 */
+		template <typename TFunc>
+		static bool visit(std::string_view name, TFunc&& func)
+		{
+			return ((name == TProcesses::name
+					 ? (func.template operator()<TProcesses>(), true)
+					 : false) || ...);
+		}
+
+		/** Creates the process named @a name for the run @a config,
+		 *  or returns nullptr if there is no such process.
+		 */
+		static std::unique_ptr<HardProcess> create(std::string_view name, RunConfig const& config)
+		{
+			std::unique_ptr<HardProcess> process{nullptr};
+			visit(name, [&]<typename TProcess>() {
+				process = std::unique_ptr<HardProcess>(new TProcess(config));
+			});
+			return process;
+		}
 	};
+
+	using Processes = ProcessRegistry<PP2Zg2ll, PP2Jets>;
+
+
+
+	template <typename TProcess, typename TPhaseSpace>
+	void HardProcessImpl<TProcess, TPhaseSpace>::integrate(IntegrationState& state, uint num_iterations, Random& rng)
+	{
+		TProcess& process = static_cast<TProcess&>(*this);
+		ScopedTimer timer(Timer::INTEGRATION);
+		
+		point_type points;
+
+		// we multiply by the deltas of the independent
+		// variables by definition of Monte Carlo integration
+		double volume = _phase_space.volume();
+
+		if (state.iterations == 0) {
+			_envelope.reset(_phase_space.mins(), _phase_space.deltas(), _num_iterations);
+			// left over from generating against the previous integration
+			_pending = PendingCopies{};
+			state.max_points.assign(num_dims, 0.0);
+		}
+
+		// numbers left over at the end of the batch are dropped
+		std::array<double, UNIFORM_BATCH*num_dims> uniforms;
+		uint next = UNIFORM_BATCH;
+		uint64_t invalid = 0;
+		for (uint i=0; i<num_iterations; i++) {
+			if (next == UNIFORM_BATCH) {
+				rng.fill(uniforms);
+				next = 0;
+			}
+			_phase_space.fill_phase_space(points, std::span<const double, num_dims>(&uniforms[num_dims*next++], num_dims));
+
+			// qualified call, so there is no virtual dispatch
+			Result dsigma_res = process.TProcess::dsigma(points);
+
+			// if it is invalid, we must redo
+			if (dsigma_res == Result::invalid_result()) {
+				invalid++;
+				i--;
+				continue;
+			}
+			
+			double weight = dsigma_res.weight * volume;
+
+			// add to total weight
+			state.weight_sum += weight;
+			state.weight_squared_sum += weight*weight;
+			_envelope.fill(points, weight);
+
+			// set maxes
+			if (weight > state.max_weight) {
+				state.max_weight = weight;
+				for (uint j=0; j<num_dims; j++)
+					state.max_points[j] = points[j];
+			}
+		}
+		state.iterations += num_iterations;
+		count(Counter::DSIGMA_CALLS, num_iterations + invalid);
+		count(Counter::INVALID_POINTS, invalid);
+		count(Counter::PDF_CALLS, _pdf_calls);
+		_pdf_calls = 0;
+	}
+
+
+	template <typename TProcess, typename TPhaseSpace>
+	HardProcessResult HardProcessImpl<TProcess, TPhaseSpace>::finish_integration(IntegrationState const& state)
+	{
+		HardProcessResult res(num_dims);
+		res.max_weight = state.max_weight;
+		res.max_points = state.max_points;
+
+		_envelope.finalize(res.max_weight);
+
+		res.result = state.result();
+		res.error = state.error();
+		return res;
+	}
+
+
+	template <typename TProcess, typename TPhaseSpace>
+	uint HardProcessImpl<TProcess, TPhaseSpace>::generate(uint num_events, double max_weight,
+														   std::vector<Event>& events,
+														   std::vector<std::vector<double>>& plot_points,
+														   Random& rng)
+	{
+		TProcess& process = static_cast<TProcess&>(*this);
+		ScopedTimer timer(Timer::GENERATION);
+		GenerationStats before = _generation_stats;
+
+		// only the independent variables enter the weight,
+		// exactly as in calculate()
+		double volume = _phase_space.volume();
+
+		point_type points;
+		reserve_more(events, num_events);
+		reserve_more(plot_points, num_events);
+
+		// Two-stage hit-or-miss: a candidate first survives with
+		// probability bound/max_weight, which only needs its envelope cell,
+		// and then with probability weight/bound, which needs dsigma().
+		// A weight above its bound gives floor(weight/bound) copies plus
+		// one more with the remaining probability, so that every point is
+		// still accepted weight/max_weight times on average.
+		// each candidate takes its point and the two numbers of the hit-or-miss
+		constexpr uint stride = num_dims + 2;
+		std::array<double, UNIFORM_BATCH*stride> uniforms;
+		uint next = UNIFORM_BATCH;
+
+		// what the previous call accepted but had no room for comes first
+		uint n = std::min(_pending.copies, num_events);
+		emit_copies(n, _pending.points, _pending.weight, _pending.res, events, plot_points, rng);
+		_pending.copies -= n;
+		_generation_stats.accepted += n;
+
+		uint64_t invalid = 0, rejected = 0;
+		while (n < num_events) {
+			if (next == UNIFORM_BATCH) {
+				rng.fill(uniforms);
+				next = 0;
+			}
+			double const* u = &uniforms[stride*next++];
+			_phase_space.fill_phase_space(points, std::span<const double, num_dims>(u, num_dims));
+			_generation_stats.candidates++;
+
+			uint cell = 0;
+			double bound = max_weight;
+			if (!_envelope.empty()) {
+				cell = _envelope.cell(points);
+				bound = _envelope.bound(cell);
+			}
+
+			// first stage: no PDFs involved
+			if (u[num_dims]*max_weight > bound) {
+				_generation_stats.pre_rejected++;
+				continue;
+			}
+
+			// second stage: the exact weight
+			Result res = process.TProcess::dsigma(points);
+			_generation_stats.evaluated++;
+			if (res == Result::invalid_result()) {
+				invalid++;
+				continue;
+			}
+
+			double weight = res.weight * volume;
+			double ratio = weight/bound;
+			uint copies = static_cast<uint>(ratio);
+			if (u[num_dims+1] < ratio - static_cast<double>(copies))
+				copies++;
+
+			if (ratio > 1.0) {
+				_generation_stats.violations++;
+				if (!_envelope.empty())
+					_envelope.raise(cell, weight, max_weight);
+			}
+
+			if (copies == 0)
+				rejected++;
+			// copies beyond this call are kept for the next one
+			uint fitting = std::min(copies, num_events - n);
+			emit_copies(fitting, points, weight, res, events, plot_points, rng);
+			if (copies > fitting)
+				_pending = PendingCopies{points, weight, std::move(res), copies - fitting};
+			n += fitting;
+			_generation_stats.accepted += fitting;
+		}
+
+		count(Counter::CANDIDATES, _generation_stats.candidates - before.candidates);
+		count(Counter::PRE_REJECTED, _generation_stats.pre_rejected - before.pre_rejected);
+		count(Counter::DSIGMA_CALLS, _generation_stats.evaluated - before.evaluated);
+		count(Counter::INVALID_POINTS, invalid);
+		count(Counter::HIT_OR_MISS_REJECTED, rejected);
+		count(Counter::ENVELOPE_VIOLATIONS, _generation_stats.violations - before.violations);
+		count(Counter::EVENTS, num_events);
+		count(Counter::PDF_CALLS, _pdf_calls);
+		_pdf_calls = 0;
+		return num_events;
+	}
+
+
+	template <typename TProcess, typename TPhaseSpace>
+	void HardProcessImpl<TProcess, TPhaseSpace>::emit_copies(uint copies, point_type const& points, double weight, Result const& res,
+															 std::vector<Event>& events, std::vector<std::vector<double>>& plot_points,
+															 Random& rng)
+	{
+		TProcess& process = static_cast<TProcess&>(*this);
+		for (uint c=0; c<copies; c++) {
+			// generate a list of particles
+			std::vector<Particle> particles;
+			process.TProcess::generate_particles(points, particles, rng);
+			events.emplace_back(weight, particles, res.scale);
+			if (res.components)
+				events.back().set_components(*res.components);
+
+			// plot the phase space points and the chosen additional values
+			std::vector<double> plot(points.begin(), points.end());
+			plot.insert(plot.end(), res.additional_vals.begin(), res.additional_vals.end());
+			plot_points.emplace_back(std::move(plot));
+		}
+	}
 	
 }; // namespace ColSim
 
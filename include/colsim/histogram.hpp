@@ -0,0 +1,53 @@
+#ifndef __HISTOGRAM_HPP
+#define __HISTOGRAM_HPP
+
+#include <string>
+#include <vector>
+
+#include "colsim/checkpoint.hpp"
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	/** Histogram with equal bins over [low, high), keeping the sum of
+	 *  the weights and of their squares in every bin. Both are plain
+	 *  sums, so histograms filled by separate runs add up exactly.
+	 */
+	class Histogram
+	{
+	private:
+		std::string _name;
+		double _low, _high;
+		// bin 0 is the underflow and the last bin the overflow
+		std::vector<double> _sum_w, _sum_w2;
+
+	public:
+		Histogram(std::string const& name, double low, double high, uint bins);
+		~Histogram() = default;
+
+		inline std::string const& name() const { return _name; }
+		inline double low() const { return _low; }
+		inline double high() const { return _high; }
+		inline uint bins() const { return _sum_w.size() - 2; }
+		inline double width() const { return (_high - _low)/bins(); }
+
+		/** Sum of the weights in bin @a i, which runs from 0 to bins()-1.
+		 */
+		inline double sum_w(uint i) const { return _sum_w[i+1]; }
+		inline double sum_w2(uint i) const { return _sum_w2[i+1]; }
+		inline double underflow() const { return _sum_w.front(); }
+		inline double overflow() const { return _sum_w.back(); }
+
+		void fill(double x, double weight=1.0);
+
+		/** Adds the contents of @a other, which must have the same binning.
+		 */
+		void merge(Histogram const& other);
+
+		void save(CheckpointWriter& out) const;
+		static Histogram load(CheckpointReader& in);
+	};
+}; // namespace colsim
+
+
+#endif // __HISTOGRAM_HPP
@@ -0,0 +1,217 @@
+#ifndef __LOGGER_HPP
+#define __LOGGER_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "colsim/common.hpp"
+
+// messages below this level are compiled out, errors never are
+#ifndef COLSIM_LOG_LEVEL
+#define COLSIM_LOG_LEVEL 0
+#endif
+
+namespace colsim
+{
+	enum LogType : int
+	{
+		LOG_DEBUG = 0,
+		LOG_INFO,
+		LOG_WARNING,
+		LOG_ERROR,
+		LOG_ERROR_NOQUIT,
+		LOG_NUM_LOG_TYPES
+	};
+
+	inline std::array<std::string_view, LOG_NUM_LOG_TYPES> log_string_reps{"DEBUG", "INFO", "WARNING", "ERROR", "ERROR"};
+
+	/** Whether messages of type @a log_type are compiled in at all.
+	 */
+	inline constexpr bool log_enabled(int log_type) {
+		return log_type >= COLSIM_LOG_LEVEL || log_type >= LOG_ERROR;
+	}
+
+
+	/** Counts the messages of one call site and lets through only the
+	 *  first FIRST of them, then every one whose count is a power of two.
+	 *  A warning raised in a hot loop then costs one atomic increment.
+	 */
+	class LogLimit
+	{
+	public:
+		static constexpr uint64_t FIRST = 10;
+
+	private:
+		std::atomic<uint64_t> _count{0};
+
+	public:
+		inline uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+		/** Counts a message, returning its count if it is to
+		 *  be written and 0 if not.
+		 */
+		inline uint64_t pass() {
+			uint64_t n = _count.fetch_add(1, std::memory_order_relaxed) + 1;
+			return n <= FIRST || std::has_single_bit(n) ? n : 0;
+		}
+	};
+
+
+	/** Writes the log from a thread of its own, so that the threads
+	 *  logging only format their message into a ring of their own.
+	 *
+	 *  Each thread's ring has one writer, that thread, and one reader,
+	 *  whoever holds the drain lock, so neither side takes a lock. The
+	 *  background thread drains all rings every DRAIN_INTERVAL and writes
+	 *  the messages in the order they were made to stdout and, if one
+	 *  is open, the log file. A thread finding its ring full drains the
+	 *  rings itself, so messages are never lost. Errors are written
+	 *  straight away, after everything logged before them.
+	 */
+	class Logger
+	{
+	public:
+		// longer messages are cut short
+		static constexpr uint MAX_LINE = 512;
+		static constexpr uint RING_SIZE = 256;
+		static constexpr std::chrono::milliseconds DRAIN_INTERVAL{20};
+
+	private:
+		struct Slot
+		{
+			uint64_t sequence;
+			uint length;
+			std::array<char, MAX_LINE> text;
+		};
+
+		struct Ring
+		{
+			std::array<Slot, RING_SIZE> slots{};
+			std::atomic<uint64_t> head{0}, tail{0};
+			// set when its thread exits; it is dropped once drained
+			std::atomic<bool> retired{false};
+		};
+
+		/** A thread's ring, handed back when the thread exits.
+		 */
+		struct RingHandle
+		{
+			std::shared_ptr<Ring> ring{};
+			~RingHandle();
+		};
+
+		std::atomic<uint64_t> _sequence{0};
+
+		std::mutex _rings_mutex;
+		std::vector<std::shared_ptr<Ring>> _rings{};
+
+		// held by whoever reads the rings and writes the messages out
+		std::mutex _drain_mutex;
+		std::ofstream _file{};
+		std::string _file_path{};
+		std::vector<Slot const*> _pending{};
+
+		std::mutex _wake_mutex;
+		std::condition_variable _wake{};
+		bool _stopping{false};
+		// once stopped, messages are written by their threads directly
+		std::atomic<bool> _stopped{false};
+		std::thread _thread{};
+
+		Logger();
+		~Logger() = default;
+
+	public:
+		Logger(Logger const&) = delete;
+		Logger& operator=(Logger const&) = delete;
+
+		/** The logger of the program. It lives until the program
+		 *  exits, when it writes out what is left and stops.
+		 */
+		static Logger& instance();
+
+		/** Also writes the log to @a path, replacing what was there,
+		 *  unless it already does. An empty @a path closes the file.
+		 */
+		void open(std::string const& path);
+
+		/** Writes out everything logged so far.
+		 */
+		void flush();
+
+		/** Logs a message, noting @a count, the number of times it came up,
+		 *  when that is more than its call site lets through one by one.
+		 *  The message is formatted straight into the next slot of the
+		 *  calling thread's ring, or for an error into one on the stack,
+		 *  which is written out at once.
+		 */
+		template <typename... TArgs>
+		void write(int log_type, std::string_view prefix, uint64_t count,
+				   std::format_string<TArgs...> fmt_string, TArgs&& ...args)
+		{
+			Slot direct;
+			Ring* r = ring_for(log_type);
+			Slot& slot = r ? r->slots[r->head.load(std::memory_order_relaxed) % RING_SIZE] : direct;
+
+			// one character is kept for the line break
+			char* out = slot.text.data();
+			char* end = out + MAX_LINE - 1;
+			out = std::format_to_n(out, end - out, "[{}] {}: ", log_string_reps[log_type], prefix).out;
+			out = std::format_to_n<char*, TArgs...>(out, end - out, fmt_string, std::forward<TArgs>(args)...).out;
+			if (count > LogLimit::FIRST)
+				out = std::format_to_n(out, end - out, " ({} times so far)", count).out;
+			*out++ = '\n';
+			slot.length = out - slot.text.data();
+
+			if (r)
+				publish(*r);
+			else
+				write_direct(slot);
+		}
+
+	private:
+		/** The ring of the calling thread, made on its first message,
+		 *  or null while the thread is exiting.
+		 */
+		Ring* ring();
+
+		/** The ring a message of type @a log_type goes to, with its next
+		 *  slot free, or null if it is to be written out straight away.
+		 */
+		Ring* ring_for(int log_type);
+
+		/** Hands the slot just written over to the background thread.
+		 */
+		void publish(Ring& r);
+
+		/** Writes @a slot out after everything logged before it.
+		 */
+		void write_direct(Slot const& slot);
+
+		/** Writes out everything in the rings; the drain lock is held.
+		 */
+		void drain();
+
+		void write_out(std::string_view text);
+
+		/** Writes out what is left and stops the background thread.
+		 */
+		void stop();
+	};
+}; // namespace colsim
+
+
+#endif // __LOGGER_HPP
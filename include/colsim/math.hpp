@@ -5,6 +5,7 @@
 #include <random>
 #include <type_traits>
 
+#include "colsim/random.hpp"
 #include "colsim/utils.hpp"
 
 namespace colsim
@@ -14,16 +15,25 @@ namespace colsim
 		std::is_invocable_v<T, double, void*> &&
 		std::same_as<std::invoke_result_t<T, double, void*>, double>;
 
+	/** Generator behind the free functions below, seeded at random.
+	 *  The library itself only draws from the Random objects it is
+	 *  handed, so this is for quick use outside of it and is not
+	 *  safe to use from several threads.
+	 */
 	struct RandomUtils final
 	{
-		std::random_device dev;
-		std::mt19937_64 mt;
+		Random rng;
 
-		RandomUtils() : dev{}, mt(dev()) {}
+		RandomUtils() : rng(std::random_device{}()) {}
 	};
     int rand_int(uint low, uint high);
 	double rand_double(double low, double high);
 	double rand_double();
+
+	/** Uniform double in [0,1) drawn from @a engine rather than the
+	 *  global generator, so that each thread can keep its own stream.
+	 */
+	inline double rand_double(Random& engine) { return engine.uniform(); }
 	inline RandomUtils random_utils{};
 
 	// WARNING: this requires an initial guess,
@@ -45,7 +55,7 @@ namespace colsim
 		}
 
 		if (n >= numEvals)
-			log(LOG_ERROR, "NewtonRaphson():", "Failed to converge.");
+			COLSIM_LOG(LOG_ERROR_NOQUIT, "NewtonRaphson():", "Failed to converge; see SafeguardedNewton() in roots.hpp for a version returning a status.");
 			
 	    return x0;
 	}
@@ -53,22 +63,26 @@ namespace colsim
 	template <MathFunction TMathFunction>
 	double Bisection(TMathFunction func, double min, double max, uint numEvals, double precision, void* params)
 	{
-		int count = 0;
+		uint count = 0;
 		double range = max - min;
 		double midpoint = std::numeric_limits<double>::max(); // arbitrary large number to obviously indicate error
+
+		// the ends are only ever replaced by the midpoint,
+		// so their values can be carried along
+		double funcMin = func(min, params);
+		double funcMax = func(max, params);
 		
 		while ((range > precision) && (count < numEvals)) {
 			midpoint = (min+max)/2.0;
-
-			double funcMin = func(min, params);
-			double funcMax = func(max, params);
 			double funcMidpoint = func(midpoint, params);
 
-			if ((funcMin * funcMidpoint) < 0)
+			if ((funcMin * funcMidpoint) < 0) {
 				max = midpoint;
-			else if ((funcMidpoint * funcMax) < 0)
+				funcMax = funcMidpoint;
+			} else if ((funcMidpoint * funcMax) < 0) {
 				min = midpoint;
-			else
+				funcMin = funcMidpoint;
+			} else
 				break;
 
 			count += 1;
@@ -0,0 +1,159 @@
+#ifndef __METRICS_HPP
+#define __METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "colsim/common.hpp"
+
+// counting and timing compile to nothing when this is 0
+#ifndef COLSIM_METRICS
+#define COLSIM_METRICS 1
+#endif
+
+namespace colsim
+{
+	enum class Counter : uint
+	{
+		DSIGMA_CALLS,          // every call, integration and generation alike
+		INVALID_POINTS,        // points dsigma() rejected as outside the phase space
+		CANDIDATES,            // points drawn during generation
+		PRE_REJECTED,          // candidates rejected by the weight envelope alone
+		HIT_OR_MISS_REJECTED,  // candidates rejected after computing their weight
+		ENVELOPE_VIOLATIONS,   // weights above the bound of their cell
+		EVENTS,                // events generated
+		PDF_CALLS,             // lookups of one or all partons at one x and Q2 made by the hard processes;
+		                       // PDFSet itself counts nothing, so other callers are not included
+		ROOT_EVALUATIONS,      // function calls of the root finders
+		SHOWER_TRIALS,         // candidate emissions above the cutoff
+		SHOWER_VETOES,         // candidates vetoed by the splitting function or alpha_s
+		EMISSIONS,             // emissions accepted
+		NUM_COUNTERS
+	};
+
+	enum class Timer : uint
+	{
+		INTEGRATION,
+		GENERATION,
+		SHOWER,
+		PDF_LOAD,
+		NUM_TIMERS
+	};
+
+	inline constexpr uint NUM_COUNTERS = static_cast<uint>(Counter::NUM_COUNTERS);
+	inline constexpr uint NUM_TIMERS = static_cast<uint>(Timer::NUM_TIMERS);
+
+	inline constexpr std::array<std::string_view, NUM_COUNTERS> counter_names{
+		"dsigma_calls", "invalid_points", "candidates", "pre_rejected", "hit_or_miss_rejected",
+		"envelope_violations", "events", "pdf_calls", "root_evaluations",
+		"shower_trials", "shower_vetoes", "emissions"
+	};
+	inline constexpr std::array<std::string_view, NUM_TIMERS> timer_names{
+		"integration", "generation", "shower", "pdf_load"
+	};
+
+
+	/** Totals of every counter and timer, over all threads.
+	 *  Timers add up the time of each thread, so with many
+	 *  threads they can exceed the time that passed.
+	 */
+	struct Metrics
+	{
+		std::array<uint64_t, NUM_COUNTERS> counters{};
+		std::array<uint64_t, NUM_TIMERS> nanoseconds{};
+		std::array<uint64_t, NUM_TIMERS> calls{};
+
+		inline uint64_t operator[](Counter c) const { return counters[static_cast<uint>(c)]; }
+		inline double seconds(Timer t) const { return 1e-9*static_cast<double>(nanoseconds[static_cast<uint>(t)]); }
+		inline uint64_t calls_of(Timer t) const { return calls[static_cast<uint>(t)]; }
+
+		/** What was counted after @a earlier was collected.
+		 */
+		Metrics operator-(Metrics const& earlier) const;
+
+		/** The totals so far of every thread there was.
+		 */
+		static Metrics collect();
+
+		std::string to_json() const;
+		void write_json(std::string const& path) const;
+	};
+
+
+	namespace metrics_detail
+	{
+		/** The counters of one thread. Only that thread writes them,
+		 *  so they need no more than relaxed loads and stores.
+		 */
+		struct ThreadMetrics
+		{
+			std::array<std::atomic<uint64_t>, NUM_COUNTERS> counters{};
+			std::array<std::atomic<uint64_t>, NUM_TIMERS> nanoseconds{};
+			std::array<std::atomic<uint64_t>, NUM_TIMERS> calls{};
+		};
+
+		inline void add(std::atomic<uint64_t>& value, uint64_t n) {
+			value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+		inline thread_local ThreadMetrics* current = nullptr;
+
+		/** Makes the counters of the calling thread.
+		 */
+		ThreadMetrics* register_thread();
+
+		inline ThreadMetrics& thread_metrics() {
+			ThreadMetrics* m = current;
+			if (!m) [[unlikely]]
+				m = register_thread();
+			return *m;
+		}
+	}; // namespace metrics_detail
+
+
+	/** Adds @a n to counter @a c of the calling thread. Loops should
+	 *  count locally and call this once at their end.
+	 */
+	inline void count([[maybe_unused]] Counter c, [[maybe_unused]] uint64_t n=1) {
+		if constexpr (COLSIM_METRICS)
+			metrics_detail::add(metrics_detail::thread_metrics().counters[static_cast<uint>(c)], n);
+	}
+
+
+	/** Adds the time from its making to its end to a timer.
+	 */
+	class ScopedTimer
+	{
+	private:
+		[[maybe_unused]] Timer _timer;
+		[[maybe_unused]] std::chrono::steady_clock::time_point _start{};
+
+	public:
+		inline ScopedTimer(Timer timer)
+			: _timer{timer}
+		{
+			if constexpr (COLSIM_METRICS)
+				_start = std::chrono::steady_clock::now();
+		}
+
+		inline ~ScopedTimer() {
+			if constexpr (COLSIM_METRICS) {
+				auto elapsed = std::chrono::steady_clock::now() - _start;
+				metrics_detail::ThreadMetrics& m = metrics_detail::thread_metrics();
+				metrics_detail::add(m.nanoseconds[static_cast<uint>(_timer)],
+									std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+				metrics_detail::add(m.calls[static_cast<uint>(_timer)], 1);
+			}
+		}
+
+		ScopedTimer(ScopedTimer const&) = delete;
+		ScopedTimer& operator=(ScopedTimer const&) = delete;
+	};
+}; // namespace colsim
+
+
+#endif // __METRICS_HPP
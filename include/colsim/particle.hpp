@@ -1,6 +1,8 @@
 #ifndef __PARTICLE_HPP
 #define __PARTICLE_HPP
 
+#include <cstdint>
+#include <cstdlib>
 #include <format>
 #include <string>
 
@@ -8,24 +10,42 @@
 
 namespace colsim
 {
+	enum class ParticleStatus : uint8_t
+	{
+		INCOMING,
+		OUTGOING
+	};
+
 	class Particle
 	{
 	private:
 		FourVector _momentum;
 		int _pid;
 		std::string _name;
+		ParticleStatus _status;
 
 	public:
-		Particle(int pid, std::string const& name)
-			: _pid{pid}, _name{name}
+		Particle(int pid, std::string const& name, ParticleStatus status=ParticleStatus::OUTGOING)
+			: _pid{pid}, _name{name}, _status{status}
 		{}
 		Particle(FourVector const& momentum,
-				 int pid, std::string const& name)
-			: _momentum{momentum}, _pid{pid}, _name{name}
+				 int pid, std::string const& name, ParticleStatus status=ParticleStatus::OUTGOING)
+			: _momentum{momentum}, _pid{pid}, _name{name}, _status{status}
 		{}
 
 		inline FourVector const& momentum() const { return _momentum; }
+		inline void set_momentum(FourVector const& momentum) { _momentum = momentum; }
 		inline int pid() const { return _pid; }
+		inline ParticleStatus status() const { return _status; }
+		inline bool is_incoming() const { return _status == ParticleStatus::INCOMING; }
+
+		/** Whether the particle is a quark or a gluon,
+		 *  and so can start a parton shower.
+		 */
+		inline bool is_coloured() const {
+			int id = std::abs(_pid);
+			return (id >= 1 && id <= 6) || id == 21;
+		}
 		inline std::string const& name() const { return _name; }
 
 		inline double e() const { return  _momentum.e(); }
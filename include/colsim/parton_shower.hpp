@@ -1,69 +1,275 @@
 #ifndef __PARTON_SHOWER_HPP
 #define __PARTON_SHOWER_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
 #include <random>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include "colsim/alphas.hpp"
 #include "colsim/common.hpp"
+#include "colsim/emission_store.hpp"
+#include "colsim/math.hpp"
 
 namespace colsim
 {
+	enum class PartonKind : uint8_t
+	{
+		QUARK,
+		GLUON
+	};
+
+	/** Counters of the shower's veto algorithm, binned in log10(t/GeV^2)
+	 *  and z to show where trial emissions are rejected.
+	 */
+	struct VetoStats
+	{
+		static constexpr uint NUM_T_BINS = 16; // log10(t) from 0 to 8
+		static constexpr uint NUM_Z_BINS = 10;
+		static constexpr double LOG10_T_MAX = 8.0;
+
+		struct Counts
+		{
+			unsigned long trials{0};           // trial emissions above the cutoff
+			unsigned long splitting_vetoes{0}; // rejected by the splitting function
+			unsigned long alphas_vetoes{0};    // rejected by alpha_s
+			unsigned long accepted{0};
+
+			inline double acceptance_rate() const {
+				return trials > 0 ? static_cast<double>(accepted)/static_cast<double>(trials) : 0.0;
+			}
+		};
+
+		std::array<Counts, NUM_T_BINS*NUM_Z_BINS> bins{};
+
+		/** Counts of the region containing @a t and @a z,
+		 *  with values outside the binning put in the edge bins.
+		 */
+		inline Counts& bin(double t, double z)
+		{
+			int it = static_cast<int>(std::log10(t) * (NUM_T_BINS/LOG10_T_MAX));
+			int iz = static_cast<int>(z * NUM_Z_BINS);
+			it = std::clamp(it, 0, static_cast<int>(NUM_T_BINS)-1);
+			iz = std::clamp(iz, 0, static_cast<int>(NUM_Z_BINS)-1);
+			return bins[it*NUM_Z_BINS + iz];
+		}
+		inline Counts const& at(uint t_bin, uint z_bin) const { return bins[t_bin*NUM_Z_BINS + z_bin]; }
+
+		/** Counts summed over every region.
+		 */
+		Counts total() const;
+
+		void merge(VetoStats const& other);
+	};
+
+
+	/** Final state shower of quarks and gluons, with the splittings
+	 *  q->qg, g->gg and g->qqbar competing at every step.
+	 */
 	class PartonShower
 	{
+	public:
+		enum Branch : uint
+		{
+			Q_TO_QG,
+			G_TO_GG,
+			G_TO_QQBAR,
+			NUM_BRANCHES
+		};
+
+		// g->qqbar is overestimated with all of these flavours active
+		static constexpr uint MAX_FLAVOURS = 5;
+
 	protected:
 		AlphaS _alphas;
+		// what the partons of evolve() and evolve_batch() start as
+		PartonKind _start_kind;
+
+		// filled by every thread of evolve_batch(), hence the lock
+		mutable VetoStats _veto_stats{};
+		mutable std::mutex _veto_stats_mutex{};
 
 	public:
-		PartonShower() : _alphas(1) {};
+		PartonShower(RunConfig const& config, PartonKind start_kind=PartonKind::QUARK)
+			: _alphas(1, config), _start_kind{start_kind}
+		{}
 		~PartonShower() = default;
 
-		struct Emission
+		using Emission = colsim::Emission;
+
+
+		// number of partons evolved side by side by each thread in evolve_batch()
+		static constexpr uint NUM_LANES = 16;
+
+	protected:
+		// evolution stops once the scale drops below sqrt(FAC_CUTOFF) times the cutoff;
+		// the emission scale solve uses the slightly lower FAC_T so as not to miss any
+		static constexpr double FAC_T = 3.9999;
+		static constexpr double FAC_CUTOFF = 4.0;
+
+		/** Sum over the branches open to a parton of the z-integral of their
+		 *  overestimates between eps and 1-eps, with eps = Qcut/sqrt(t),
+		 *  divided by alpha_s/(2 pi). It has the form
+		 *  c_log*log((1-eps)/eps) + c_flat*(1-2*eps): the soft
+		 *  singular branches give the first term and g->qqbar the second.
+		 *  The constants below hold for any t; step_overestimate()
+		 *  tightens them for a step starting from a given scale.
+		 */
+		struct Overestimate
 		{
-			double t, z, pT_2, m_2;
-			bool generated, continue_evol;
+			double c_log, c_flat;
 		};
+		static constexpr Overestimate QUARK_OVERESTIMATE{2.0*CF, 0.0};
+		static constexpr Overestimate GLUON_OVERESTIMATE{2.0*CA, TR*MAX_FLAVOURS};
+
+		/** Overestimate for a @a kind parton evolving down from @a Q.
+		 *  Below Q the z-range only shrinks, eps >= Qcut/Q, which bounds
+		 *  how close each splitting function gets to its overestimate at
+		 *  the edges. The number of flavours open to g->qqbar is likewise
+		 *  at most that at Q. Both only ever lower the constants, so the
+		 *  result stays an upper bound over the whole step.
+		 */
+		Overestimate step_overestimate(PartonKind kind, double Q, double Qcut) const;
 
+		// the splitting functions and their overestimates
+		double Pqq(double z) const;
+		double Pqq_over(double z, Overestimate const& over) const;
+		double Pgg(double z) const;
+		double Pgg_over(double z, Overestimate const& over) const;
+		double Pgq(double z, uint nf) const;
+		double Pgq_over(double z, Overestimate const& over) const;
 
-		struct Params
+		// the emission scale is found to within this many units of log(t)
+		static constexpr double NEWTON_TOLERANCE = 1e-8;
+		static constexpr uint MAX_NEWTON_ITERATIONS = 50;
+
+		/** The function whose root is the emission scale, (log t/Q^2)*a*rho - log(r),
+		 *  at l = log(t/Qcut^2) with lQ = log(Q^2/Qcut^2), along with its
+		 *  derivative with respect to l.
+		 */
+		std::pair<double, double> emission_scale_func(double l, double lQ, double log_r, double alphaSOver,
+													  Overestimate const& over) const;
+
+		/** The emission scale equation for one step, in terms of l = log(t/Qcut^2):
+		 *  its root lies in [@a l_min, @a l0], with @a l0 the closed-form
+		 *  estimate the solve starts from.
+		 */
+		struct EmissionScaleEquation
 		{
-			double Q, Qcut, r, alphas_over;
+			double lQ, log_r;
+			double l_min, l0;
 		};
 
-	protected:
-		double tgamma(double z, double alphaSOver);
-		double tgamma_inv(double r, double alphaSOver);
+		/** Sets up @a eq for a step down from @a Q. Returns false if the
+		 *  estimate already falls below the cutoff, so there is no emission.
+		 */
+		bool emission_scale_equation(double Q, double Qcut, double r, double tfac, double alphaSOver,
+									 Overestimate const& over, EmissionScaleEquation& eq) const;
+
+		/** Samples the next emission scale below @a Q from the summed
+		 *  overestimate @a over of all branches, by inverting it in closed
+		 *  form and polishing the result with Newton's method. Returns the
+		 *  maximum double if there is no emission above the cutoff.
+		 */
+		double get_t_emission(double Q, double Qcut, double r, double tfac, double alphaSOver,
+							  Overestimate const& over) const;
+
+		/** Picks the branch of a @a kind parton that emits at @a t, each
+		 *  with probability proportional to its part of @a over.
+		 *  @a r is rescaled to a fresh uniform number for later use.
+		 */
+		Branch get_branch(PartonKind kind, double t, double Qcut, Overestimate const& over, double& r) const;
 
-		double zp_over(double t);
-		double zm_over(double t);
+		/** Samples z for @a branch at @a t from its overestimate.
+		 */
+		double get_z_emission(Branch branch, double t, double Qcut, double r, double r_flip) const;
 
-		double Pqq(double z);
-		double Pqq_over(double z);
+		/** PDG id of the parton emitted by @a branch at @a t. For g->qqbar
+		 *  this is the antiquark, of a flavour picked uniformly by @a r from
+		 *  those open at t, and the quark carries on the shower.
+		 */
+		int emitted_pid(Branch branch, double t, double r) const;
 
-		double emission_scale_func(double log_T_Q2, void* _params);
-		double get_t_emission(double Q, double Qcut, double r, double tfac, double alphaSOver);
+		/** Ratio of the splitting function of @a branch to its part of @a over.
+		 */
+		double splitting_ratio(Branch branch, double t, double z, Overestimate const& over) const;
 
-		double get_z_emission(double t, double r, double alphaSOver);
-		double get_pt_2(double t, double z);
-		double get_m_2(double t, double z);
+		double get_pt_2(double t, double z) const;
+		double get_m_2(double t, double z) const;
+
+		/** Evolves the partons starting at @a Qs in lanes of @a NUM_LANES,
+		 *  each step running every lane through the same emission kernels.
+		 *  The kernels are still scalar code with branches, such as the
+		 *  Newton solve of get_t_emission(), so the compiler does not
+		 *  vectorise across lanes; what the lanes give is independent
+		 *  work to overlap, not SIMD.
+		 *  A lane whose parton has finished evolving is refilled with the
+		 *  next one. The i-th parton draws its random numbers from stream
+		 *  @a first_stream + i of @a seed, so its shower does not depend
+		 *  on which lane or thread it ends up in.
+		 *  Showers are added to @a store in the order they finish,
+		 *  and if given, @a order receives the index in @a Qs of each.
+		 *  @a kinds gives the kind of each parton, or is empty if they all
+		 *  start as @a _start_kind.
+		 */
+		void evolve_lanes(std::span<const double> Qs, std::span<const PartonKind> kinds, double Qmin, double alphaSOver,
+						  uint64_t seed, uint64_t first_stream, EmissionStore& store, std::vector<uint>* order=nullptr) const;
+
+		/** As evolve_lanes(), with the showers put back in the order of @a Qs.
+		 */
+		void evolve_ordered(std::span<const double> Qs, std::span<const PartonKind> kinds, double Qmin, double alphaSOver,
+							uint64_t seed, uint64_t first_stream, EmissionStore& store) const;
 
-		Emission generate_emission(double Q, double Qcut, double tfac, double alphaSOver);
 	public:
-		std::vector<Emission> evolve(double Q, double Qmin, double alphaSOver);
+		/** Evolves a single parton from @a Q down to @a Qmin,
+		 *  appending its emissions to @a store as one shower.
+		 */
+		void evolve(double Q, double Qmin, double alphaSOver, EmissionStore& store, Random& rng);
+
+		/** Evolves one parton for each starting scale in @a Qs, appending
+		 *  their showers to @a store in the same order. The partons are
+		 *  split over @a num_threads threads. Every parton gets its own
+		 *  random number stream under a seed drawn from @a rng, so the
+		 *  result is the same whatever the number of threads.
+		 */
+		void evolve_batch(std::span<const double> Qs, double Qmin, double alphaSOver,
+						  EmissionStore& store, uint num_threads, Random& rng) const;
+
+		/** As above, but on the calling thread only. If given,
+		 *  @a kinds says whether each parton is a quark or a gluon.
+		 */
+		void evolve_batch(std::span<const double> Qs, double Qmin, double alphaSOver,
+						  EmissionStore& store, Random& rng,
+						  std::span<const PartonKind> kinds={}) const;
 
 		AlphaS const& alphas() const { return _alphas; }
-		
-		
+
+		/** Veto counters of every shower evolved so far.
+		 */
+		VetoStats veto_stats() const;
+		void reset_veto_stats();
 
 
 	private:
 		// helper for printing the list of emissions
 		// for a particle evolution
 		// uses the logger's output stream
-		void log_emissions_table(std::vector<Emission> const& emissions);
+		void log_emissions_table(std::span<const Emission> emissions) const;
 		
 	};
 
-	class GluonShower : public PartonShower { };
+	/** Shower whose partons start out as gluons.
+	 */
+	class GluonShower : public PartonShower
+	{
+	public:
+		GluonShower(RunConfig const& config) : PartonShower(config, PartonKind::GLUON) {}
+	};
 	
 }; // namespace ColSim
 
@@ -0,0 +1,109 @@
+#ifndef __PDF_HPP
+#define __PDF_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "colsim/common.hpp"
+
+#include "LHAPDF/LHAPDF.h"
+
+namespace colsim
+{
+	/** A PDF set member, loaded on first use and shared by everything
+	 *  in the program that asks for it.
+	 *
+	 *  Handles are made by get(), which never reads any files, so runs
+	 *  that do not need the PDF, e.g. showers on their own, never load
+	 *  it. The set is read by load(), once, however many threads call it.
+	 *
+	 *  With a cache directory, the set is tabulated once on a fine grid in
+	 *  log(x/(1-x)) and log(Q2), written there as a binary file, and every
+	 *  later run maps that file into memory instead of having LHAPDF parse
+	 *  its text grids. Lookups then interpolate cubically on the uniform
+	 *  grid, which agrees with LHAPDF to much better than the Monte Carlo
+	 *  errors, but not bit for bit. Remove the file after updating the set.
+	 */
+	class PDFSet
+	{
+	public:
+		// partons kept in the cache, ordered by PDG ID from -6 to 6
+		// with the gluon in the middle, as LHAPDF orders them too
+		static constexpr uint NUM_PARTONS = 13;
+		static constexpr uint NUM_X = 400;
+		static constexpr uint NUM_Q2 = 200;
+
+	private:
+		std::string _name;
+		int _member;
+		std::string _cache_path;
+
+		mutable std::once_flag _loaded{};
+		// one of these is set after loading
+		mutable std::unique_ptr<const LHAPDF::PDF> _lhapdf{};
+		mutable void* _map{nullptr};
+		mutable size_t _map_size{0};
+
+		// the mapped grid: its bounds and spacing,
+		// alpha_s at every Q2 and xf at every (Q2, x)
+		mutable double _u_min{0.0}, _du{0.0};
+		mutable double _v_min{0.0}, _dv{0.0};
+		mutable double const* _alphas{nullptr};
+		mutable double const* _xf{nullptr};
+
+		PDFSet(std::string const& name, int member, std::string const& cache_path);
+
+	public:
+		~PDFSet();
+		PDFSet(PDFSet const&) = delete;
+		PDFSet& operator=(PDFSet const&) = delete;
+
+		/** The handle of member @a member of set @a name, the same one
+		 *  every time it is asked for. An empty @a cache_dir uses LHAPDF
+		 *  directly.
+		 */
+		static std::shared_ptr<const PDFSet> get(std::string const& name, int member, std::string const& cache_dir="");
+
+		inline std::string const& name() const { return _name; }
+		inline int member() const { return _member; }
+
+		/** Reads the set, or its cached grid, unless done already.
+		 *  Must have been called before any of the lookups below.
+		 */
+		void load() const;
+
+		/** x times the density of parton @a id at @a x and @a q2.
+		 */
+		double xfxQ2(int id, double x, double q2) const;
+
+		/** x times the densities of all partons at @a x and @a q2,
+		 *  ordered by PDG ID from -6 to 6.
+		 */
+		void xfxQ2(double x, double q2, std::vector<double>& xfs) const;
+
+		double alphasQ2(double q2) const;
+
+	private:
+		/** Tabulates the set from LHAPDF and writes it to the cache.
+		 */
+		void write_cache() const;
+
+		/** Maps the cache into memory, returning false if
+		 *  it is missing or not a grid of this set.
+		 */
+		bool map_cache() const;
+
+		/** Position of @a x and @a q2 on the grid: the first of the four
+		 *  nodes along each axis, and the weights of those nodes.
+		 */
+		void locate(double x, double q2, uint& ix, uint& iq,
+					std::array<double, 4>& wx, std::array<double, 4>& wq) const;
+	};
+}; // namespace colsim
+
+
+#endif // __PDF_HPP
@@ -2,100 +2,155 @@
 #define __PHASE_SPACE_HPP
 
 #include "colsim/common.hpp"
+#include "colsim/math.hpp"
+#include "colsim/run_config.hpp"
 
+#include <array>
+#include <span>
+#include <string>
 #include <vector>
 #include <initializer_list>
 
 namespace colsim
 {
 
-	class PhaseSpace
+	/** The part of a phase space which does not depend on its dimension:
+	 *  the information used for plotting and the hook for recomputing
+	 *  the ranges whenever config file variables change.
+	 */
+	class PhaseSpaceBase
 	{
 	protected:
-		uint _num_dims;
-		std::vector<double> _min, _max, _delta;
-
 		// --- to be used for plotting ---
+		// ranges of every plotted quantity, i.e. the independent
+		// variables followed by any additional values of interest
+		std::vector<double> _plot_min, _plot_max;
+
 		// string names for phase space elements
 		std::vector<std::string> _names;
 		std::vector<std::string> _titles;
 		std::vector<std::string> _xlabels;
 		std::vector<std::string> _ylabels;
-		
+
 	public:
-		PhaseSpace() = delete; // must provide a dimension
-		
-		// initializes random number generator and arrays with the number of dimensions
-		// for this particular phase space generator
-		PhaseSpace(uint num_dims,
-				   std::initializer_list<std::string> names,
-				   std::initializer_list<std::string> titles={},
-				   std::initializer_list<std::string> xlabels={},
-				   std::initializer_list<std::string> ylabels={}) :
-			_num_dims{num_dims},
+		PhaseSpaceBase(std::initializer_list<std::string> names,
+					   std::initializer_list<std::string> titles={},
+					   std::initializer_list<std::string> xlabels={},
+					   std::initializer_list<std::string> ylabels={}) :
 			_names{names}, _titles{titles}, _xlabels{xlabels}, _ylabels{ylabels}
 		{}
-		~PhaseSpace() = default;
+		virtual ~PhaseSpaceBase() = default;
 
-		// some getters
-		inline uint  dims() const { return _num_dims; }
-		inline std::vector<double> const& mins()       const { return _min;   }
-		inline std::vector<double> const& maxes()      const { return _max;   }
-	    inline std::vector<double> const& deltas()     const { return _delta; }
+		virtual uint dims() const = 0;
+
+		inline std::vector<double> const& plot_mins()  const { return _plot_min; }
+		inline std::vector<double> const& plot_maxes() const { return _plot_max; }
 
 		inline std::vector<std::string> const& names()   const { return _names; }
 		inline std::vector<std::string> const& titles()  const { return _titles; }
 		inline std::vector<std::string> const& xlabels() const { return _xlabels; }
 		inline std::vector<std::string> const& ylabels() const { return _ylabels; }
-		
-		/** Fills @a vec with @a numDims elements corresponding
-		 *  to randomly generated phase space points.
+
+		/** Main routine that sets mins, maxes, deltas
+		 *  from the configuration given to the constructor.
 		 */
-		void fill_phase_space(std::vector<double>& vec);
+		virtual void set_ranges() = 0;
+	};
+
+
+	/** Phase space of @a N independent variables. The dimension is
+	 *  known at compile time, so the bounds and points are plain arrays
+	 *  and the loops over them can be unrolled.
+	 */
+	template <uint N>
+	class PhaseSpace : public PhaseSpaceBase
+	{
+	public:
+		static constexpr uint num_dims = N;
+		using point_type = std::array<double, N>;
 
 	protected:
-		/** simple helper for filling the delta values
-		 *  once the mins and maxes have been provided
+		point_type _min{}, _max{}, _delta{};
+		double _volume{0.0};
+
+	public:
+		using PhaseSpaceBase::PhaseSpaceBase;
+		virtual ~PhaseSpace() = default;
+
+		// some getters
+		inline uint dims() const override { return N; }
+		inline point_type const& mins()   const { return _min;   }
+		inline point_type const& maxes()  const { return _max;   }
+	    inline point_type const& deltas() const { return _delta; }
+
+		/** Product of the deltas, i.e. the factor each weight
+		 *  is multiplied by in the Monte Carlo integration.
 		 */
-		void fill_delta();
+		inline double volume() const { return _volume; }
 
+		/** Fills @a point with a phase space point drawn from @a rng.
+		 */
+		inline void fill_phase_space(point_type& point, Random& rng) const
+		{
+			rng.fill(point);
+			fill_phase_space(point, std::span<const double, N>(point));
+		}
+
+		/** Fills @a point with the phase space point at the
+		 *  uniforms @a u in [0,1), e.g. taken from a bulk draw.
+		 */
+		inline void fill_phase_space(point_type& point, std::span<const double, N> u) const
+		{
+			for (uint i=0; i<N; i++)
+				point[i] = u[i]*_delta[i] + _min[i];
+		}
 
-	public:
-		/** Main routine that sets mins, maxes, deltas.
-		 *  called by the constructor as well as when
-		 *  any config file variables change
+	protected:
+		/** simple helper for filling the delta values
+		 *  once the mins and maxes have been provided
 		 */
-		void set_ranges() { }
+		inline void fill_delta()
+		{
+			_volume = 1.0;
+			for (uint i=0; i<N; i++) {
+				_delta[i] = _max[i] - _min[i];
+				_volume *= _delta[i];
+			}
+		}
 	};
 
 
 	// specifically considers the phase space specified by
 	// cos(theta), y (the rapidity), and tau (determined by rho, technically,
 	// which is actually what we generate a random number for)
-	class PhaseSpace_TauYCosth : public PhaseSpace
+	class PhaseSpace_TauYCosth final : public PhaseSpace<3>
 	{
 	private:
+		// taken from the configuration
+		double _s, _trans_energy_2, _min_cutoff_energy_2;
+
 		// these are determined via the ECM
 		double _rho_min;
 		double _rho_max;
 		double _drho;
 	public:
-		PhaseSpace_TauYCosth();
+		PhaseSpace_TauYCosth(RunConfig const& config);
 		~PhaseSpace_TauYCosth() = default;
-		
-		void set_ranges();
+
+		void set_ranges() override;
 	};
 
 
-	class PhaseSpace_EtEta : public PhaseSpace
+	class PhaseSpace_EtEta final : public PhaseSpace<2>
 	{
 	private:
-		
+		double _min_cutoff_energy;
+
 	public:
-		PhaseSpace_EtEta();
+		PhaseSpace_EtEta(RunConfig const& config);
 		~PhaseSpace_EtEta() = default;
-		
-		void set_ranges();
+
+		void set_ranges() override;
 	};
 };
 
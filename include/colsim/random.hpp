@@ -0,0 +1,133 @@
+#ifndef __RANDOM_HPP
+#define __RANDOM_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	/** Counter-based Philox4x32-10 generator (Salmon et al., SC11).
+	 *  The n-th output of stream @a stream under @a seed is a fixed
+	 *  function of the three, computed by ten rounds of multiplication
+	 *  and xor on the counter. So there is no state to share between
+	 *  threads: every worker takes its own stream, runs are reproduced
+	 *  from the seed alone, and skipping ahead costs nothing.
+	 *  Satisfies UniformRandomBitGenerator with 64 bit output, so it
+	 *  can also drive the distributions of <random>.
+	 */
+	class Random
+	{
+	public:
+		using result_type = uint64_t;
+
+	private:
+		static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+		static constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+		uint64_t _seed, _stream;
+		// outputs drawn so far; each block of the cipher gives two
+		uint64_t _position{0};
+		std::array<uint32_t, 4> _block{};
+
+	public:
+		Random(uint64_t seed=0, uint64_t stream=0) : _seed{seed}, _stream{stream} {}
+		~Random() = default;
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		inline uint64_t seed() const { return _seed; }
+		inline uint64_t stream() const { return _stream; }
+		inline uint64_t position() const { return _position; }
+
+		inline result_type operator()()
+		{
+			uint half = _position & 1;
+			if (half == 0)
+				encrypt(_position >> 1);
+			_position++;
+			return (static_cast<uint64_t>(_block[2*half]) << 32) | _block[2*half + 1];
+		}
+
+		/** Uniform double in [0,1), from the top 52 bits of one output.
+		 */
+		inline double uniform()
+		{
+			return to_unit((*this)());
+		}
+
+		/** Fills @a out with uniform doubles in [0,1), the same values as
+		 *  that many calls of uniform() would give. Whole blocks of the
+		 *  cipher are computed side by side, which the compiler turns
+		 *  into vector instructions.
+		 */
+		void fill(std::span<double> out);
+
+		/** As above, but uniform in [@a low, @a high).
+		 */
+		void fill(std::span<double> out, double low, double high);
+
+		/** Moves @a n outputs ahead, as if they had been drawn.
+		 */
+		inline void skip(uint64_t n)
+		{
+			_position += n;
+			if (_position & 1)
+				encrypt(_position >> 1);
+		}
+
+		/** Independent generator with the same seed,
+		 *  for handing one stream to each worker.
+		 */
+		inline Random substream(uint64_t stream) const { return Random(_seed, stream); }
+
+		/** The raw cipher: block @a counter of the stream
+		 *  under @a key, exposed for checking against reference values.
+		 */
+		static inline std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+		{
+			for (uint round=0; round<10; round++) {
+				uint64_t p0 = static_cast<uint64_t>(M0) * counter[0];
+				uint64_t p1 = static_cast<uint64_t>(M1) * counter[2];
+				counter = {
+					static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+					static_cast<uint32_t>(p1),
+					static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+					static_cast<uint32_t>(p0)
+				};
+				key[0] += W0;
+				key[1] += W1;
+			}
+			return counter;
+		}
+
+	private:
+		// blocks of the cipher computed together by fill()
+		static constexpr uint FILL_BLOCKS = 8;
+
+		/** Puts the top 52 bits of @a x into the mantissa of a double
+		 *  in [1,2) and shifts it down, which unlike an integer to
+		 *  double conversion also exists as a vector instruction.
+		 */
+		static inline double to_unit(uint64_t x)
+		{
+			return std::bit_cast<double>((x >> 12) | 0x3FF0000000000000) - 1.0;
+		}
+
+		inline void encrypt(uint64_t block)
+		{
+			_block = philox(
+				{static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+				 static_cast<uint32_t>(_stream), static_cast<uint32_t>(_stream >> 32)},
+				{static_cast<uint32_t>(_seed), static_cast<uint32_t>(_seed >> 32)});
+		}
+	};
+}; // namespace colsim
+
+
+#endif // __RANDOM_HPP
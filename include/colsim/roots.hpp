@@ -0,0 +1,248 @@
+#ifndef __ROOTS_HPP
+#define __ROOTS_HPP
+
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	/** One dimensional function whose root is to be found.
+	 */
+	template <typename T>
+	concept RootFunction = std::is_invocable_r_v<double, T, double>;
+
+	/** Function returning its value and derivative as a pair,
+	 *  as used by Newton's method.
+	 */
+	template <typename T>
+	concept RootFunctionWithDerivative =
+		std::is_invocable_v<T, double> &&
+		std::convertible_to<std::invoke_result_t<T, double>, std::pair<double, double>>;
+
+	enum class RootStatus
+	{
+		CONVERGED,
+		MAX_ITERATIONS,      // ran out of iterations before reaching the tolerance
+		NO_BRACKET,          // the function has the same sign at both ends
+		DERIVATIVE_VANISHED, // Newton's method hit a flat or non-finite derivative
+		OUT_OF_BOUNDS        // Newton's method left the allowed interval
+	};
+
+	/** Outcome of a root search. @a evaluations counts every call
+	 *  of the function, which is what the solvers are compared by.
+	 */
+	struct RootResult
+	{
+		double root;
+		uint evaluations;
+		RootStatus status;
+
+		inline bool converged() const { return status == RootStatus::CONVERGED; }
+	};
+
+
+	/** Brent's method: inverse quadratic interpolation and secant steps,
+	 *  falling back to bisection whenever those do not make enough progress.
+	 *  Requires a sign change over [@a lo, @a hi]; converges superlinearly
+	 *  and never worse than bisection. Every function value is computed once.
+	 */
+	template <RootFunction TFunc>
+	RootResult Brent(TFunc&& func, double lo, double hi, double tolerance, uint max_iterations)
+	{
+		double a = lo, b = hi;
+		double fa = func(a), fb = func(b);
+		RootResult res{b, 2, RootStatus::MAX_ITERATIONS};
+
+		if (fa == 0.0) { res.root = a; res.status = RootStatus::CONVERGED; return res; }
+		if (fb == 0.0) { res.root = b; res.status = RootStatus::CONVERGED; return res; }
+		if ((fa > 0.0) == (fb > 0.0)) {
+			res.status = RootStatus::NO_BRACKET;
+			return res;
+		}
+
+		// c is the previous iterate, with b and c bracketing the root
+		double c = a, fc = fa;
+		double d = b - a, e = d;
+
+		for (uint i=0; i<max_iterations; i++) {
+			if ((fb > 0.0) == (fc > 0.0)) {
+				c = a; fc = fa;
+				d = b - a; e = d;
+			}
+			if (std::abs(fc) < std::abs(fb)) {
+				a = b;  b = c;  c = a;
+				fa = fb; fb = fc; fc = fa;
+			}
+
+			double tol = 2.0*std::numeric_limits<double>::epsilon()*std::abs(b) + 0.5*tolerance;
+			double m = 0.5*(c - b);
+			if (std::abs(m) <= tol || fb == 0.0) {
+				res.root = b;
+				res.status = RootStatus::CONVERGED;
+				return res;
+			}
+
+			if (std::abs(e) >= tol && std::abs(fa) > std::abs(fb)) {
+				// try interpolating
+				double p, q, r;
+				double s = fb/fa;
+				if (a == c) {
+					// secant
+					p = 2.0*m*s;
+					q = 1.0 - s;
+				} else {
+					// inverse quadratic
+					q = fa/fc;
+					r = fb/fc;
+					p = s*(2.0*m*q*(q - r) - (b - a)*(r - 1.0));
+					q = (q - 1.0)*(r - 1.0)*(s - 1.0);
+				}
+				if (p > 0.0)
+					q = -q;
+				else
+					p = -p;
+
+				if (2.0*p < std::min(3.0*m*q - std::abs(tol*q), std::abs(e*q))) {
+					e = d;
+					d = p/q;
+				} else {
+					d = m;
+					e = m;
+				}
+			} else {
+				d = m;
+				e = m;
+			}
+
+			a = b;
+			fa = fb;
+			b += (std::abs(d) > tol) ? d : (m > 0.0 ? tol : -tol);
+			fb = func(b);
+			res.evaluations++;
+		}
+
+		res.root = b;
+		return res;
+	}
+
+
+	/** Regula falsi with the Illinois modification: whenever the same end
+	 *  of the bracket is kept twice in a row its function value is halved,
+	 *  which restores superlinear convergence. Requires a sign change.
+	 */
+	template <RootFunction TFunc>
+	RootResult Illinois(TFunc&& func, double lo, double hi, double tolerance, uint max_iterations)
+	{
+		double a = lo, b = hi;
+		double fa = func(a), fb = func(b);
+		RootResult res{b, 2, RootStatus::MAX_ITERATIONS};
+
+		if ((fa > 0.0) == (fb > 0.0) && fa != 0.0 && fb != 0.0) {
+			res.status = RootStatus::NO_BRACKET;
+			return res;
+		}
+
+		int side = 0;
+		double previous = std::numeric_limits<double>::max();
+		for (uint i=0; i<max_iterations; i++) {
+			double c = (a*fb - b*fa) / (fb - fa);
+			double fc = func(c);
+			res.evaluations++;
+			res.root = c;
+
+			if (fc == 0.0 || std::abs(c - previous) < tolerance) {
+				res.status = RootStatus::CONVERGED;
+				return res;
+			}
+
+			if ((fc > 0.0) == (fb > 0.0)) {
+				b = c; fb = fc;
+				if (side == -1)
+					fa *= 0.5;
+				side = -1;
+			} else {
+				a = c; fa = fc;
+				if (side == 1)
+					fb *= 0.5;
+				side = 1;
+			}
+			previous = c;
+
+			if (std::abs(b - a) < tolerance) {
+				res.status = RootStatus::CONVERGED;
+				return res;
+			}
+		}
+
+		return res;
+	}
+
+
+	/** Newton's method with analytic derivatives, starting from @a x0 and
+	 *  confined to [@a lo, @a hi]. Once the iterates have seen the function
+	 *  change sign, steps leaving that bracket are replaced by bisection.
+	 *  Without a bracket, a step leaving [@a lo, @a hi] ends the search
+	 *  with @a OUT_OF_BOUNDS rather than wandering off.
+	 */
+	template <RootFunctionWithDerivative TFunc>
+	RootResult SafeguardedNewton(TFunc&& func, double x0, double lo, double hi, double tolerance, uint max_iterations)
+	{
+		RootResult res{x0, 0, RootStatus::MAX_ITERATIONS};
+
+		// most recent points with a negative and a positive value
+		double neg = 0.0, pos = 0.0;
+		bool have_neg = false, have_pos = false;
+
+		double x = x0;
+		for (uint i=0; i<max_iterations; i++) {
+			auto [f, df] = func(x);
+			res.evaluations++;
+			res.root = x;
+
+			if (f == 0.0) {
+				res.status = RootStatus::CONVERGED;
+				return res;
+			}
+			if (f < 0.0) { neg = x; have_neg = true; }
+			else         { pos = x; have_pos = true; }
+			bool bracketed = have_neg && have_pos;
+
+			double next;
+			if (df != 0.0 && std::isfinite(df)) {
+				next = x - f/df;
+			} else if (bracketed) {
+				next = 0.5*(neg + pos);
+			} else {
+				res.status = RootStatus::DERIVATIVE_VANISHED;
+				return res;
+			}
+
+			if (bracketed) {
+				double blo = std::min(neg, pos), bhi = std::max(neg, pos);
+				if (next <= blo || next >= bhi)
+					next = 0.5*(blo + bhi);
+			} else if (next < lo || next > hi) {
+				res.status = RootStatus::OUT_OF_BOUNDS;
+				return res;
+			}
+
+			double step = next - x;
+			x = next;
+			res.root = x;
+			if (std::abs(step) < tolerance) {
+				res.status = RootStatus::CONVERGED;
+				return res;
+			}
+		}
+
+		return res;
+	}
+}; // namespace colsim
+
+
+#endif // __ROOTS_HPP
@@ -0,0 +1,88 @@
+#ifndef __RUN_CONFIG_HPP
+#define __RUN_CONFIG_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "colsim/common.hpp"
+#include "colsim/pdf.hpp"
+
+namespace colsim
+{
+	/** Configuration of a single run, read once from a config file.
+	 *  It is passed to the processes, phase spaces and showers when they
+	 *  are made, and they keep their own copies of what they use. So
+	 *  any number of runs with different configurations can live in one
+	 *  program. After loading, fields can still be changed before the
+	 *  configuration is handed over, followed by update_squares()
+	 *  to keep the squared fields in line with them.
+	 */
+	struct RunConfig final
+	{
+		using value_type = std::unordered_map<std::string, std::string>;
+
+		// general settings
+		double ecm{0.0}, s{0.0};
+		std::string pdf_name{};
+		int pdf_mem{0};
+		// where PDF sets are cached as binary grids, empty for not at all
+		std::string pdf_cache_dir{};
+		// shared by every object made from this configuration, and
+		// only read from disk once a hard process needs it
+		std::shared_ptr<const PDFSet> pdf{nullptr};
+		// seed of every random number stream; 0 picks one at random,
+		// which sets @a random_seed
+		uint64_t seed{0};
+		bool random_seed{false};
+		// where the run is checkpointed, empty for not at all,
+		// and how many iterations or events go between checkpoints
+		std::string checkpoint_file{};
+		uint checkpoint_interval{0};
+		// this run is shard @a shard_index of @a num_shards, taking
+		// random number stream @a shard_index, and its result
+		// goes to @a result_file, if set
+		uint shard_index{0}, num_shards{1};
+		std::string result_file{};
+		// where stop() writes the counters and timers as JSON, if set
+		std::string metrics_file{};
+		// where stop() writes a timeline of the stages each thread ran, if set
+		std::string trace_file{};
+
+		// hard scattering settings
+		std::string process{};
+		int num_iterations{0};
+		double min_cutoff_energy{0.0}, min_cutoff_energy_2{0.0};
+		double trans_energy{0.0}, trans_energy_2{0.0};
+		bool store_me_components{false};
+
+		// parton showering settings
+		double initial_evol_e{0.0}, initial_evol_e_2{0.0};
+		bool fixed_scale{true};
+		double evol_energy_cutoff{0.0};
+		uint num_threads{1};
+
+		/** Recomputes @a s and the squared energies after the
+		 *  fields they come from were changed.
+		 */
+		void update_squares();
+
+		/** The settings that the result of a run depends on, one
+		 *  'Key=value' per line. A checkpoint is only continued by
+		 *  a run with the same. A seed picked at random is left out,
+		 *  since a resumed run takes its seed from the checkpoint.
+		 */
+		std::string fingerprint() const;
+
+		/** Reads the configuration from @a config_file_path. Keys the file
+		 *  does not set take their defaults, and an empty path gives
+		 *  the default configuration.
+		 */
+		static RunConfig load(std::string const& config_file_path="");
+	};
+}; // namespace colsim
+
+
+
+#endif // __RUN_CONFIG_HPP
@@ -0,0 +1,58 @@
+#ifndef __RUN_RESULT_HPP
+#define __RUN_RESULT_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "colsim/common.hpp"
+#include "colsim/hard_process.hpp"
+#include "colsim/histogram.hpp"
+
+namespace colsim
+{
+	/** What a run, or one shard of a run, has to show for itself: the
+	 *  sums of the cross section integration, the generation counters
+	 *  and histograms of the generated events. Everything in it is a sum
+	 *  or a maximum, so the results of the shards of a run merge into
+	 *  exactly what a single run over all of their points would give.
+	 */
+	struct RunResult
+	{
+		// written first, so that the file says what it is
+		static constexpr std::string_view KIND{"ColSim run result"};
+
+		// the run this came from; shards of one run agree on all of it
+		std::string process{};
+		uint32_t mode{0};
+		double ecm{0.0};
+		uint64_t seed{0};
+		uint num_shards{1};
+		// the shards contained, in the order they were merged
+		std::vector<uint> shards{};
+
+		IntegrationState integration{};
+		uint64_t num_events{0};
+		GenerationStats generation_stats{};
+		std::vector<Histogram> histograms{};
+
+		inline double cross_section() const { return integration.result(); }
+		inline double cross_section_error() const { return integration.error(); }
+
+		/** Whether every shard of the run has been merged in.
+		 */
+		inline bool complete() const { return shards.size() == num_shards; }
+
+		/** Adds the shards of @a other, which must come from the
+		 *  same run and not overlap with the ones already here.
+		 */
+		void merge(RunResult const& other);
+
+		void write(std::string const& path) const;
+		static RunResult read(std::string const& path);
+	};
+}; // namespace colsim
+
+
+#endif // __RUN_RESULT_HPP
@@ -0,0 +1,77 @@
+#ifndef __SCAN_HPP
+#define __SCAN_HPP
+
+#include <vector>
+
+#include "colsim/common.hpp"
+#include "colsim/hard_process.hpp"
+#include "colsim/random.hpp"
+#include "colsim/run_config.hpp"
+
+namespace colsim
+{
+	/** Cross section at one point of a scan.
+	 */
+	struct ScanResult
+	{
+		double cross_section{0.0}, error{0.0};
+		double max_weight{0.0};
+		uint64_t iterations{0};
+	};
+
+
+	/** Cross sections at many configurations, e.g. an ECM or cut scan,
+	 *  computed together: the points are spread over one set of threads,
+	 *  and each PDF set is loaded once for all points that use it.
+	 *
+	 *  When integrating to a target precision, every ANCHOR_SPACING-th
+	 *  point is integrated first, and the points between take the
+	 *  variance of their nearest anchor to size their first batch.
+	 *  Which point takes which is fixed by the order of the points
+	 *  alone, and point i draws from random number stream i, so the
+	 *  results do not depend on the number of threads. Neighbouring
+	 *  points should therefore be next to each other in the list.
+	 */
+	class Scan
+	{
+	public:
+		static constexpr uint ANCHOR_SPACING = 8;
+		// points integrated to a target precision go in batches
+		// of at least this many iterations
+		static constexpr uint MIN_BATCH = 10000;
+
+	private:
+		uint _num_threads;
+		double _target_error;
+
+	public:
+		/** A scan over @a num_threads threads. With a @a target_error,
+		 *  the relative error aimed for, each point is integrated until
+		 *  it gets there, with its NumXSIterations as the limit. Without,
+		 *  each point does exactly NumXSIterations iterations.
+		 */
+		Scan(uint num_threads, double target_error=0.0);
+		~Scan() = default;
+
+		/** Cross section at each of @a points. The processes are those
+		 *  named by the points, and the random numbers come from
+		 *  the Seed of the first point.
+		 */
+		std::vector<ScanResult> run(std::vector<RunConfig> points);
+
+	private:
+		/** Integrates @a process in batches until the target error is
+		 *  reached, the first batch being @a first_batch iterations.
+		 */
+		ScanResult integrate(HardProcess& process, RunConfig const& config,
+							 uint64_t first_batch, Random& rng) const;
+
+		/** Size of the first batch for reaching the target error,
+		 *  if the relative variance is that of @a neighbour.
+		 */
+		uint64_t predict_iterations(ScanResult const& neighbour, RunConfig const& config) const;
+	};
+}; // namespace colsim
+
+
+#endif // __SCAN_HPP
@@ -0,0 +1,66 @@
+#ifndef __SHOWER_KINEMATICS_HPP
+#define __SHOWER_KINEMATICS_HPP
+
+#include <span>
+#include <vector>
+
+#include "colsim/common.hpp"
+#include "colsim/emission_store.hpp"
+#include "colsim/event.hpp"
+#include "colsim/fourvector.hpp"
+#include "colsim/particle.hpp"
+#include "colsim/random.hpp"
+
+namespace colsim
+{
+	/** Turns the showers of an event into four-momenta. Each outgoing
+	 *  coloured parton is replaced by the partons it emitted and the one
+	 *  left at the end of its shower. Showering gives each of those groups
+	 *  a mass, so in the rest frame of the final state all three-momenta
+	 *  are scaled down by a common factor, chosen so that the energy adds
+	 *  up again, and each group is boosted onto its scaled momentum.
+	 *  The event's total four-momentum is thereby kept.
+	 *  Incoming partons would need backwards evolution,
+	 *  so they are not showered at all.
+	 */
+	class ShowerKinematics
+	{
+	private:
+		// a parton or colourless particle of the event and what replaced it
+		struct Group
+		{
+			uint first, last;
+			FourVector momentum; // before showering, in the rest frame of the final state
+			double m_2;          // after showering
+		};
+
+		// reused from one event to the next
+		std::vector<Group> _groups{};
+
+		// the scale factor is found to this precision
+		static constexpr double RESCALE_TOLERANCE = 1e-12;
+		static constexpr uint MAX_RESCALE_ITERATIONS = 100;
+
+	public:
+		ShowerKinematics() = default;
+		~ShowerKinematics() = default;
+
+		/** Appends the final state of @a event to @a out, with its showers
+		 *  taken from @a record. Random numbers, for the azimuth of each
+		 *  emission, come from @a rng. Returns false, adding nothing,
+		 *  if the showers carry more mass than the event has energy.
+		 */
+		bool reconstruct(Event const& event, EmissionStore const& record, Random& rng,
+						 std::vector<Particle>& out);
+
+	private:
+		/** Appends the partons of a shower of @a emissions starting
+		 *  from a parton @a pid with momentum @a p.
+		 */
+		void add_shower(FourVector const& p, int pid, std::span<const Emission> emissions,
+						Random& rng, std::vector<Particle>& out) const;
+	};
+}; // namespace colsim
+
+
+#endif // __SHOWER_KINEMATICS_HPP
@@ -0,0 +1,97 @@
+#ifndef __TRACE_HPP
+#define __TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	/** One stage that ran on one thread. Names, categories and
+	 *  argument names must be string literals, as only the
+	 *  pointers are kept.
+	 */
+	struct TraceEvent
+	{
+		char const* name;
+		char const* category;
+		char const* arg_name;
+		int64_t arg;
+		int64_t start_ns, duration_ns;
+	};
+
+
+	/** Records which thread ran which stage when, and writes it out
+	 *  in the trace event format of chrome://tracing and Perfetto.
+	 *  Every thread records into a buffer of its own, so recording
+	 *  never waits on other threads. Nothing is recorded until
+	 *  enable() is called, and then until the end of the program.
+	 */
+	class Tracer
+	{
+	private:
+		std::atomic<bool> _enabled{false};
+		std::chrono::steady_clock::time_point _epoch{};
+
+		Tracer() = default;
+
+	public:
+		static Tracer& instance();
+
+		/** Starts recording; times are taken from the first call.
+		 */
+		void enable();
+		inline bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+		inline int64_t now() const {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count();
+		}
+
+		/** Adds @a event to the buffer of the calling thread.
+		 */
+		void record(TraceEvent const& event);
+
+		/** The name the calling thread is shown under,
+		 *  rather than its number.
+		 */
+		void name_thread(std::string const& name);
+
+		/** Writes everything every thread recorded so far to @a path.
+		 */
+		void write(std::string const& path) const;
+	};
+
+
+	/** Records its lifetime as a stage, if the tracer is enabled.
+	 */
+	class TraceScope
+	{
+	private:
+		TraceEvent _event;
+		bool _enabled;
+
+	public:
+		inline TraceScope(char const* name, char const* category, char const* arg_name=nullptr, int64_t arg=0)
+			: _event{name, category, arg_name, arg, 0, 0}, _enabled{Tracer::instance().enabled()}
+		{
+			if (_enabled)
+				_event.start_ns = Tracer::instance().now();
+		}
+
+		inline ~TraceScope() {
+			if (_enabled) {
+				_event.duration_ns = Tracer::instance().now() - _event.start_ns;
+				Tracer::instance().record(_event);
+			}
+		}
+
+		TraceScope(TraceScope const&) = delete;
+		TraceScope& operator=(TraceScope const&) = delete;
+	};
+}; // namespace colsim
+
+
+#endif // __TRACE_HPP
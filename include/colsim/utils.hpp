@@ -6,6 +6,9 @@
 #include <format>
 #include <string>
 #include <iostream>
+#include <utility>
+
+#include "colsim/logger.hpp"
 
 namespace colsim
 {
@@ -18,32 +21,52 @@ namespace colsim
 	inline constexpr char const* ANSI_COLOR_CYAN =        "\x1b[36m";
 	inline constexpr char const* ANSI_COLOR_RESET =       "\x1b[0m";
 	
-	enum LogType : int
-	{
-		LOG_DEBUG = 0,
-		LOG_INFO,
-		LOG_WARNING,
-		LOG_ERROR,
-		LOG_ERROR_NOQUIT,
-		LOG_NUM_LOG_TYPES
-	};
-
-	inline std::array<std::string_view, LOG_NUM_LOG_TYPES> log_string_reps{"DEBUG", "INFO", "WARNING", "ERROR", "ERROR"};
 	inline std::array<std::string_view, LOG_NUM_LOG_TYPES> log_string_colors{ANSI_COLOR_GREEN, ANSI_COLOR_RESET, ANSI_COLOR_YELLOW, ANSI_COLOR_RED, ANSI_COLOR_RED};
 
 	// TODO: better handle setting global flags
 	inline bool debug_flag{false};
 	inline bool& getDebugFlag() { return debug_flag; }
 
+	/** Logs a message of type @a log_type with the prefix and format
+	 *  arguments that follow. Types below COLSIM_LOG_LEVEL are discarded
+	 *  at compile time, arguments and all, and an error ends the
+	 *  program once it is written.
+	 */
+#define COLSIM_LOG(log_type, ...) \
+	do { if constexpr (::colsim::log_enabled(log_type)) ::colsim::log(log_type, __VA_ARGS__); } while (0)
+
+	/** As above, for a message raised in a hot loop, which is only
+	 *  written as often as @a limit, belonging to the call site, lets it through.
+	 */
+#define COLSIM_LOG_LIMITED(limit, log_type, ...) \
+	do { if constexpr (::colsim::log_enabled(log_type)) ::colsim::log(limit, log_type, __VA_ARGS__); } while (0)
+
+
+	/** Logs a message through the Logger, whatever its type;
+	 *  COLSIM_LOG is what leaves out the disabled types.
+	 */
 	template <typename... TArgs>
 	void log(int log_type, std::string_view prefix, std::format_string<TArgs...> fmt_string, TArgs&& ...args)
 	{
 		if (log_type == LOG_DEBUG && !debug_flag)
 			return;
-			
-		std::string log_text = std::vformat(fmt_string.get(), std::make_format_args(args...));
-		std::string all_text = std::format("[{}] {}: {}\n", log_string_reps[log_type], prefix, log_text);
-		std::cout << all_text;
+
+		Logger::instance().write<TArgs...>(log_type, prefix, 0, fmt_string, std::forward<TArgs>(args)...);
+
+		if (log_type == LOG_ERROR)
+			exit(EXIT_FAILURE);
+	}
+
+	template <typename... TArgs>
+	void log(LogLimit& limit, int log_type, std::string_view prefix, std::format_string<TArgs...> fmt_string, TArgs&& ...args)
+	{
+		if (log_type == LOG_DEBUG && !debug_flag)
+			return;
+
+		uint64_t count = limit.pass();
+		if (count == 0)
+			return;
+		Logger::instance().write<TArgs...>(log_type, prefix, count, fmt_string, std::forward<TArgs>(args)...);
 
 		if (log_type == LOG_ERROR)
 			exit(EXIT_FAILURE);
@@ -1,91 +1,96 @@
 #include "colsim/alphas.hpp"
 
+#include <bit>
+#include <cmath>
+
 namespace colsim
 {
-    
-    double AlphaS::beta0(uint nf) const {
-		
-        double Nf = static_cast<
-        double>(nf);
-		return (11.0/6.0)*CA - (2.0/3.0)*TR*Nf;
-	}
 
-	
-    double AlphaS::beta1(uint nf) const {
-		
-        double Nf = static_cast<
-        double>(nf);
-		return (17.0/6.0)*std::pow(CA,2) - ((5.0/3.0)*CA + CF)*TR*Nf;
+	AlphaS::AlphaS(uint order, RunConfig const& config)
+		: _order{order}, _fixed_scale{config.fixed_scale},
+		  _fixed_scale_val{config.initial_evol_e/2.0}, _cutoff{config.evol_energy_cutoff}
+	{
+		// each region starts from the value at the threshold above it,
+		// so they have to be set up from the top down
+		_regions[2] = FlavourRegion{Z_MASS_2, ALPHAS_Z, B0[5], B1[5], 0};
+		_alphas_b = calc_alphas(_regions[2], B_MASS_2);
+		_regions[1] = FlavourRegion{B_MASS_2, _alphas_b, B0[4], B1[4], 0};
+		_alphas_c = calc_alphas(_regions[1], C_MASS_2);
+		_regions[0] = FlavourRegion{C_MASS_2, _alphas_c, B0[3], B1[3], 0};
+
+		fill_table(_regions[0], TABLE_T_MIN, C_MASS_2);
+		fill_table(_regions[1], C_MASS_2, B_MASS_2);
+		fill_table(_regions[2], B_MASS_2, TABLE_T_MAX);
 	}
 
-	
-    double AlphaS::calc_alphas_LO(double t) const {
-		// determine reference scale given t
-		
-        double tref, asref;
-        double b0;
-
-		if (t >= B_MASS_2) {
-			// if above B mass, use Z mass
-			tref = Z_MASS_2;
-			asref = ALPHAS_Z;
-			// 5 flavors
-			b0 = beta0(5) / (2.0*PI);
-		} else if (t >= C_MASS_2) {
-			// use B
-			tref = B_MASS_2;
-			asref = _alphas_b;
-			// 4 flavors now
-			b0 = beta0(4) / (2.0*PI);
-		} else {
-			// otherwise just use C
-			tref = C_MASS_2;
-			asref = _alphas_c;
-			// 3 flavors
-			b0 = beta0(3) / (2.0*PI);
+
+	void AlphaS::fill_table(FlavourRegion& r, double t_lo, double t_hi) {
+		constexpr uint64_t interval = uint64_t{1} << TABLE_SHIFT;
+
+		// intervals are aligned to the mantissa so that
+		// each one lies within a single factor of two in t
+		r.first_bits = std::bit_cast<uint64_t>(t_lo) & ~(interval - 1);
+		uint num_intervals = ((std::bit_cast<uint64_t>(t_hi) - r.first_bits) >> TABLE_SHIFT) + 1;
+		r.inv_alphas.resize(num_intervals);
+
+		for (uint i=0; i<num_intervals; i++) {
+			// within an interval t is linear in u, so the
+			// cubic is fitted at u = 0, 1/3, 2/3 and 1
+			uint64_t start = r.first_bits + i*interval;
+			double ta = std::bit_cast<double>(start);
+			double tb = std::bit_cast<double>(start + interval);
+			std::array<double, 4> g;
+			for (uint k=0; k<4; k++)
+				g[k] = 1.0/calc_alphas(r, ta + (tb - ta)*k/3.0);
+
+			// forward differences on the nodes v = 3u = 0,1,2,3, then the
+			// Newton form of the cubic expanded in powers of u
+			double d1 = g[1] - g[0];
+			double d2 = g[2] - 2.0*g[1] + g[0];
+			double d3 = g[3] - 3.0*g[2] + 3.0*g[1] - g[0];
+			r.inv_alphas[i] = {
+				g[0],
+				3.0*(d1 - d2/2.0 + d3/3.0),
+				9.0*(d2/2.0 - d3/2.0),
+				27.0*(d3/6.0)
+			};
 		}
+	}
+
 
-		return 1.0/((1.0/asref) + b0*std::log(t/tref));
+    double AlphaS::calc_alphas_LO(FlavourRegion const& r, double t) const {
+		return 1.0/((1.0/r.asref) + r.b0*std::log(t/r.tref));
 	}
 
 	
-    double AlphaS::calc_alphas_NLO( double t) const {
-		// determine reference scale given t
-		
-        double tref, asref;
-        double b0, b1;
-
-		if (t >= B_MASS_2) {
-			// if above B mass, use Z mass
-			tref = Z_MASS_2;
-			asref = ALPHAS_Z;
-			// 5 flavors
-			b0 = beta0(5) / (2.0*PI);
-			b1 = beta1(5) / std::pow(2.0*PI,2);
-		} else if (t >= C_MASS_2) {
-			// use B
-			tref = B_MASS_2;
-			asref = _alphas_b;
-			// 4 flavors now
-			b0 = beta0(4) / (2.0*PI);
-			b1 = beta1(4) / std::pow(2.0*PI,2);
-		} else {
-			// otherwise just use C
-			tref = C_MASS_2;
-			asref = _alphas_c;
-			// 3 flavors
-			b0 = beta0(3) / (2.0*PI);
-			b1 = beta1(3) / std::pow(2.0*PI,2);
+    double AlphaS::calc_alphas_NLO(FlavourRegion const& r, double t) const {
+        double term = 1.0 + r.b0*r.asref*std::log(t/r.tref);
+		return (r.asref/term) * (1.0 - (r.b1/r.b0)*r.asref*std::log(term)/term);
+	}
+
+
+	double AlphaS::calc_alphas(FlavourRegion const& r, double t) const {
+		switch (_order) {
+			case 0: return calc_alphas_LO(r, t);
+			case 1: return calc_alphas_NLO(r, t);
 		}
+		return 0.0; // just avoid error
+	}
 
-		
-        double term = 1.0 + b0*asref*std::log(t/tref);
-		return (asref/term) * (1.0 - (b1/b0)*asref*std::log(term)/term);
+
+	double AlphaS::calc_alphas(double t) const {
+		return calc_alphas(region(t), t);
+	}
+
+
+	void AlphaS::alphas(std::span<const double> ts, std::span<double> out) const {
+		for (uint i=0; i<ts.size(); i++)
+			out[i] = alphas(ts[i]);
 	}
 
 
 	double AlphaS::alphas_scale(double t, double z) const {
-		if (SETTINGS.fixed_scale)
+		if (_fixed_scale)
 			return _fixed_scale_val;
 		else
 			return z*(1.0-z)*sqrt(t);
@@ -94,29 +99,18 @@ namespace colsim
 	}
 
 
-	double AlphaS::calc_alphas(double t) const {
-		switch (_order) {
-			case 0: return calc_alphas_LO(t);
-			case 1: return calc_alphas_NLO(t);
-		}
-		return 0.0; // just avoid error
-	}
-
-
 	double AlphaS::alphas_actual(double t, double z) const {
 		double scale = alphas_scale(t, z);
-		if (scale < SETTINGS.evol_energy_cutoff)
-			scale = SETTINGS.evol_energy_cutoff;
-		return calc_alphas(t)/(2.0*M_PI);
-		
+		if (scale < _cutoff)
+			scale = _cutoff;
+		return alphas(scale*scale)/(2.0*M_PI);
 	}
 
-	double AlphaS::alphas_over(double t) const {
-		double scale;
-		if (SETTINGS.fixed_scale)
+	double AlphaS::alphas_over(double scale) const {
+		if (_fixed_scale)
 			scale = _fixed_scale_val;
-		else
-			scale = t;
-		return calc_alphas(scale);
+		else if (scale < _cutoff)
+			scale = _cutoff;
+		return alphas(scale*scale)/(2.0*M_PI);
 	}
-}
\ No newline at end of file
+}
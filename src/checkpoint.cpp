@@ -0,0 +1,156 @@
+#include "colsim/checkpoint.hpp"
+
+#include <filesystem>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	CheckpointWriter::CheckpointWriter(std::string const& path, Mode mode)
+		: _path{path}, _tmp_path{mode == APPEND ? path : path + ".tmp"}, _mode{mode}
+	{
+		std::error_code error;
+		bool fresh = mode == REPLACE || std::filesystem::file_size(_path, error) == 0 || error;
+		_out.open(_tmp_path, std::ios::binary | (mode == APPEND ? std::ios::app : std::ios::trunc));
+		if (!_out)
+			COLSIM_LOG(LOG_ERROR, "CheckpointWriter::CheckpointWriter()", "Could not open checkpoint file '{}'", _tmp_path);
+		if (fresh) {
+			write(MAGIC);
+			write(VERSION);
+		}
+	}
+
+	void CheckpointWriter::write(std::string const& str) {
+		write(std::span<const char>(str));
+	}
+
+	void CheckpointWriter::write(Random const& rng) {
+		write(rng.seed());
+		write(rng.stream());
+		write(rng.position());
+	}
+
+	void CheckpointWriter::write(Particle const& particle) {
+		write(particle.momentum().data());
+		write(particle.pid());
+		write(particle.name());
+		write(particle.status());
+	}
+
+	void CheckpointWriter::write(Event const& event) {
+		write(event.weight());
+		write(event.Q());
+		write(event.cos_theta());
+		write(event.y());
+		write(event.first_shower());
+		write(event.num_showers());
+		write(event.components().has_value());
+		if (event.components())
+			write(*event.components());
+		write<uint64_t>(event.particles().size());
+		for (Particle const& p : event.particles())
+			write(p);
+	}
+
+	void CheckpointWriter::write(EmissionStore const& store) {
+		write(store.emissions());
+		write(store.offsets());
+	}
+
+	uint64_t CheckpointWriter::commit() {
+		_out.close();
+		if (!_out)
+			COLSIM_LOG(LOG_ERROR, "CheckpointWriter::commit()", "Failed writing checkpoint file '{}'", _tmp_path);
+
+		// a rename within one directory replaces the old file in one step
+		std::error_code error;
+		if (_mode == REPLACE) {
+			std::filesystem::rename(_tmp_path, _path, error);
+			if (error)
+				COLSIM_LOG(LOG_ERROR, "CheckpointWriter::commit()", "Could not move '{}' to '{}': {}", _tmp_path, _path, error.message());
+		}
+		uint64_t size = std::filesystem::file_size(_path, error);
+		if (error)
+			COLSIM_LOG(LOG_ERROR, "CheckpointWriter::commit()", "Could not find the size of '{}': {}", _path, error.message());
+		return size;
+	}
+
+
+
+	CheckpointReader::CheckpointReader(std::string const& path)
+		: _path{path}, _in{path, std::ios::binary}
+	{
+		if (!_in)
+			COLSIM_LOG(LOG_ERROR, "CheckpointReader::CheckpointReader()", "Could not open checkpoint file '{}'", _path);
+		if (read<uint64_t>() != CheckpointWriter::MAGIC)
+			COLSIM_LOG(LOG_ERROR, "CheckpointReader::CheckpointReader()", "'{}' is not a checkpoint file", _path);
+		uint32_t version = read<uint32_t>();
+		if (version != CheckpointWriter::VERSION)
+			COLSIM_LOG(LOG_ERROR, "CheckpointReader::CheckpointReader()",
+				"Checkpoint '{}' has version {}, expected {}", _path, version, CheckpointWriter::VERSION);
+	}
+
+	void CheckpointReader::check() {
+		if (!_in)
+			COLSIM_LOG(LOG_ERROR, "CheckpointReader::check()", "Checkpoint file '{}' ended early", _path);
+	}
+
+	std::string CheckpointReader::read_string() {
+		std::vector<char> chars;
+		read(chars);
+		return std::string(chars.begin(), chars.end());
+	}
+
+	Random CheckpointReader::read_random() {
+		uint64_t seed = read<uint64_t>();
+		uint64_t stream = read<uint64_t>();
+		Random rng(seed, stream);
+		rng.skip(read<uint64_t>());
+		return rng;
+	}
+
+	Particle CheckpointReader::read_particle() {
+		FourVector momentum(read<FourVector::value_type>());
+		int pid = read<int>();
+		std::string name = read_string();
+		ParticleStatus status = read<ParticleStatus>();
+		return Particle(momentum, pid, name, status);
+	}
+
+	Event CheckpointReader::read_event() {
+		double weight = read<double>();
+		double Q = read<double>();
+		double cos_theta = read<double>();
+		double y = read<double>();
+		uint first_shower = read<uint>();
+		uint num_showers = read<uint>();
+		std::optional<DrellYanComponents> components{};
+		if (read<bool>())
+			components = read<DrellYanComponents>();
+
+		uint64_t num_particles = read<uint64_t>();
+		std::vector<Particle> particles;
+		particles.reserve(num_particles);
+		for (uint64_t i=0; i<num_particles; i++)
+			particles.push_back(read_particle());
+
+		Event event(weight, particles, Q, cos_theta, y);
+		event.set_showers(first_shower, num_showers);
+		if (components)
+			event.set_components(*components);
+		return event;
+	}
+
+	void CheckpointReader::read(EmissionStore& store) {
+		std::vector<Emission> emissions;
+		std::vector<uint> offsets;
+		read(emissions);
+		read(offsets);
+
+		store.clear();
+		store.reserve(offsets.size() - 1, emissions.size());
+		std::span<const Emission> all(emissions);
+		for (uint i=0; i+1<offsets.size(); i++)
+			store.add_shower(all.subspan(offsets[i], offsets[i+1] - offsets[i]));
+	}
+}; // namespace colsim
@@ -1,40 +1,89 @@
 #include "colsim/colsim.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <ranges>
+#include <thread>
 
 #include "colsim/common.hpp"
+#include "colsim/concurrency.hpp"
 #include "colsim/utils.hpp"
 #include "colsim/alphas.hpp"
 #include "colsim/parton_shower.hpp"
-#include "colsim/settings.hpp"
 #include "colsim/phase_space.hpp"
 #include "colsim/math.hpp"
+#include "colsim/trace.hpp"
 
 namespace colsim
 {
+	namespace
+	{
+		/** Keys of the 'Key=value' lines of two fingerprints that differ.
+		 */
+		std::string differing_settings(std::string const& a, std::string const& b) {
+			auto lines = [](std::string const& s) {
+				return s | std::views::split('\n') | std::ranges::to<std::vector<std::string>>();
+			};
+			std::vector<std::string> lines_a = lines(a), lines_b = lines(b);
+			std::vector<std::string> keys{};
+			auto missing = [](std::vector<std::string> const& from, std::vector<std::string> const& in, std::vector<std::string>& keys) {
+				for (std::string const& line : from)
+					if (!line.empty() && std::ranges::find(in, line) == in.end())
+						keys.push_back(line.substr(0, line.find('=')));
+			};
+			missing(lines_a, lines_b, keys);
+			missing(lines_b, lines_a, keys);
+			std::ranges::sort(keys);
+			auto [end, last] = std::ranges::unique(keys);
+			keys.erase(end, last);
+
+			std::string res{};
+			for (std::string const& key : keys)
+				res += res.empty() ? key : ", " + key;
+			return res;
+		}
+	}
+
+
 	ColSimMain::ColSimMain(std::string const& log_file_path) {
-		UNUSED(log_file_path);
-	    // initalize the logger with the default file path
+		Logger::instance().open(log_file_path);
 	}
 
 	ColSimMain::~ColSimMain() {
-		log(LOG_INFO, "ColSimMain::~ColSimMain()", "Shutting down...");
+		COLSIM_LOG(LOG_INFO, "ColSimMain::~ColSimMain()", "Shutting down...");
 	}
 
 
 	void ColSimMain::init(InitFlag init_flag, std::string const& config_file_path) {
-		flag = init_flag;
-		
 		// read in the settings from the given configuration file
-		SETTINGS.load_config_file(config_file_path);
+		init(init_flag, RunConfig::load(config_file_path));
+	}
+
+	void ColSimMain::init(InitFlag init_flag, RunConfig const& config) {
+		flag = init_flag;
+		_config = config;
+		_rng = Random(_config.seed, _config.shard_index);
+		_metrics_start = Metrics::collect();
+		if (!_config.trace_file.empty())
+			Tracer::instance().enable();
 
 		// load the process given in the config file
 		switch(init_flag) {
 			case HARD_SCATTERING:
-				load_hard_process(SETTINGS.process);
+				load_hard_process(_config.process);
 				break;
 			case PARTON_SHOWERING:
-				_parton_shower = std::unique_ptr<PartonShower>(new GluonShower());
+				_parton_shower = std::unique_ptr<PartonShower>(new PartonShower(_config));
+				break;
+			case FULL:
+				load_hard_process(_config.process);
+				_parton_shower = std::unique_ptr<PartonShower>(new PartonShower(_config));
+				// only outgoing partons are showered
+				if (!Processes::has_coloured_final_state(_config.process))
+					COLSIM_LOG(LOG_WARNING, "ColSimMain::init()",
+						"Process '{}' has no outgoing quarks or gluons, so the parton shower has nothing to do.", _config.process);
 				break;
 		}
 	}
@@ -43,14 +92,21 @@ namespace colsim
 
 
 	void ColSimMain::load_hard_process(std::string const& process) {
-		if (process.compare("PP2Zg2ll") != 0)
-			log(LOG_ERROR, "ColSimMain::load_hard_process()", "Only 'PP2Zg2ll' has been implemented.");
-
-		_hard_process = std::unique_ptr<HardProcess>(new PP2Zg2ll());
+		_hard_process = Processes::create(process, _config);
+		if (_hard_process)
+			return;
+
+		std::string available{};
+		for (std::string_view name : Processes::names)
+			available += std::format(" '{}'", name);
+		COLSIM_LOG(LOG_ERROR, "ColSimMain::load_hard_process()", "Unknown process '{}'. Available processes are:{}", process, available);
 	}
 
 
 	void ColSimMain::start() {
+		if (checkpointing() && std::filesystem::exists(_config.checkpoint_file))
+			read_checkpoint();
+
 		switch(flag) {
 			case HARD_SCATTERING:
 				start_hard_process();
@@ -58,6 +114,10 @@ namespace colsim
 			case PARTON_SHOWERING:
 				start_parton_shower();
 				break;
+			case FULL:
+				start_hard_process();
+				start_parton_shower();
+				break;
 		}
 	};
 	
@@ -68,18 +128,259 @@ namespace colsim
 				return generate_event_hard_process();
 			case PARTON_SHOWERING:
 				return generate_event_parton_shower();
+			case FULL:
+				return generate_event_full();
 		}
 
 		return true; // unreachable, but gcc shuts the fuck up
 	}
 
 	void ColSimMain::generate_events(uint numEvents) {
+		uint done = 0;
+		if (_resumed && _events_requested > 0) {
+			if (numEvents != _events_requested)
+				COLSIM_LOG(LOG_ERROR, "ColSimMain::generate_events()",
+					"The checkpoint was written while generating {} events, not {}.", _events_requested, numEvents);
+			done = _events_done;
+			COLSIM_LOG(LOG_INFO, "ColSimMain::generate_events()", "Continuing from event {} of {}.", done, numEvents);
+		} else {
+			_plot_points.clear();
+			_emission_record.clear();
+			_final_particles.clear();
+			_final_offsets.resize(1);
+			// the records in the checkpoint are not these any more
+			_checkpointed = {};
+		}
+		_resumed = false;
+		_events_requested = numEvents;
+
+		// the batches are the same whether or not the run is interrupted,
+		// which keeps a resumed run identical to an uninterrupted one
+		uint interval = checkpointing() ? _config.checkpoint_interval : numEvents;
+		while (done < numEvents) {
+			uint n = std::min(interval, numEvents - done);
+			{
+				TraceScope trace("batch", "generation", "events", n);
+				generate_events_batch(n);
+			}
+			done += n;
+			if (checkpointing()) {
+				_events_done = done;
+				write_checkpoint();
+			}
+		}
+
+		switch(flag) {
+			case HARD_SCATTERING:
+			{
+				GenerationStats const& stats = _hard_process->generation_stats();
+				COLSIM_LOG(LOG_INFO, "ColSimMain::generate_events()",
+					"Pre-rejected {:.2f}% of {} candidates without calling dsigma()",
+					100.0*stats.pre_rejection_rate(), stats.candidates);
+				if (stats.violations > 0)
+					COLSIM_LOG(LOG_WARNING, "ColSimMain::generate_events()",
+						"{} points exceeded the weight envelope and were accepted with multiplicity.", stats.violations);
+				break;
+			}
+			case PARTON_SHOWERING:
+			case FULL:
+				log_veto_stats();
+				break;
+		}
+	}
+
+	void ColSimMain::generate_events_batch(uint num_events) {
+		switch(flag) {
+			case HARD_SCATTERING:
+			{
+				// the whole batch goes through a single virtual call
+				TraceScope trace("hard process", "generation", "events", num_events);
+				_hard_process->generate(num_events, _max_weight, _event_record, _plot_points, _rng);
+				break;
+			}
+			case PARTON_SHOWERING:
+			{
+				// every event starts a single parton at the same scale
+				std::vector<double> Qs(num_events, _config.initial_evol_e);
+				_emission_record.reserve(_emission_record.num_showers() + num_events,
+										 _emission_record.num_emissions() + 2*num_events);
+				_parton_shower->evolve_batch(Qs, _config.evol_energy_cutoff, shower_alphas_over(),
+											 _emission_record, _config.num_threads, _rng);
+				break;
+			}
+			case FULL:
+				generate_events_full(num_events);
+				break;
+		}
+	}
+
+
+	void ColSimMain::write_checkpoint() {
+		TraceScope trace("checkpoint", "output");
+		// the records first, so that the checkpoint never
+		// counts on records that were not written
+		append_checkpoint_records();
+		CheckpointWriter out(_config.checkpoint_file);
+
+		// settings that must match for the run to be continued
+		out.write(flag);
+		out.write(_config.fingerprint());
+
+		out.write(_rng);
+		out.write(_stage);
+		out.write(_integration.iterations);
+		out.write(_integration.weight_sum);
+		out.write(_integration.weight_squared_sum);
+		out.write(_integration.max_weight);
+		out.write(_integration.max_points);
+
+		out.write(_xs);
+		out.write(_xs_error);
+		out.write(_max_weight);
+		out.write(_max_ps_points);
+		if (_hard_process)
+			_hard_process->save(out);
+
+		out.write(_events_requested);
+		out.write(_events_done);
+		out.write(_checkpointed);
+
+		out.commit();
+	}
+
+	void ColSimMain::append_checkpoint_records() {
+		CheckpointedRecords& done = _checkpointed;
+		bool nothing_new = done.events == _event_record.size() && done.plot_points == _plot_points.size()
+			&& done.showers == _emission_record.num_showers() && done.particles == _final_particles.size()
+			&& done.final_states == num_final_states();
+		if (nothing_new)
+			return;
+
+		std::string path = checkpoint_records_file();
+		if (done.file_size == 0) {
+			std::error_code error;
+			std::filesystem::remove(path, error);
+			done = {};
+		}
+
+		// one chunk of everything added since the last checkpoint
+		CheckpointWriter out(path, CheckpointWriter::APPEND);
+		out.write<uint64_t>(_event_record.size() - done.events);
+		for (uint64_t i=done.events; i<_event_record.size(); i++)
+			out.write(_event_record[i]);
+		out.write<uint64_t>(_plot_points.size() - done.plot_points);
+		for (uint64_t i=done.plot_points; i<_plot_points.size(); i++)
+			out.write(_plot_points[i]);
+		std::span<const uint> offsets = _emission_record.offsets();
+		out.write(_emission_record.emissions().subspan(offsets[done.showers]));
+		out.write(offsets.subspan(done.showers + 1));
+		out.write<uint64_t>(_final_particles.size() - done.particles);
+		for (uint64_t i=done.particles; i<_final_particles.size(); i++)
+			out.write(_final_particles[i]);
+		out.write(std::span<const uint>(_final_offsets).subspan(done.final_states + 1));
+
+		done.file_size = out.commit();
+		done.events = _event_record.size();
+		done.plot_points = _plot_points.size();
+		done.showers = _emission_record.num_showers();
+		done.particles = _final_particles.size();
+		done.final_states = num_final_states();
+	}
+
+	void ColSimMain::read_checkpoint() {
+		std::string const& path = _config.checkpoint_file;
+		CheckpointReader in(path);
+
+		if (in.read<InitFlag>() != flag)
+			COLSIM_LOG(LOG_ERROR, "ColSimMain::read_checkpoint()", "Checkpoint '{}' was written by a run in a different mode.", path);
+		std::string fingerprint = in.read_string();
+		if (fingerprint != _config.fingerprint())
+			COLSIM_LOG(LOG_ERROR, "ColSimMain::read_checkpoint()",
+				"Checkpoint '{}' was written by a run with different settings ({}). Remove it to start over.",
+				path, differing_settings(fingerprint, _config.fingerprint()));
+
+		_rng = in.read_random();
+		if (_rng.stream() != _config.shard_index)
+			COLSIM_LOG(LOG_ERROR, "ColSimMain::read_checkpoint()",
+				"Checkpoint '{}' belongs to shard {}, not {}.", path, _rng.stream(), _config.shard_index);
+		// only a seed picked at random gets here different from the checkpoint's
+		_config.seed = _rng.seed();
+		_stage = in.read<RunStage>();
+		_integration.iterations = in.read<uint64_t>();
+		_integration.weight_sum = in.read<double>();
+		_integration.weight_squared_sum = in.read<double>();
+		_integration.max_weight = in.read<double>();
+		in.read(_integration.max_points);
+
+		_xs = in.read<double>();
+		_xs_error = in.read<double>();
+		_max_weight = in.read<double>();
+		in.read(_max_ps_points);
+		if (_hard_process)
+			_hard_process->load(in);
+
+		_events_requested = in.read<uint>();
+		_events_done = in.read<uint>();
+		_checkpointed = in.read<CheckpointedRecords>();
+		read_checkpoint_records();
+
+		_resumed = true;
+		COLSIM_LOG(LOG_INFO, "ColSimMain::read_checkpoint()",
+			"Resuming from checkpoint '{}' (seed {}, {} integration iterations, {} of {} events)",
+			path, _config.seed, _integration.iterations, _events_done, _events_requested);
+	}
+
+	void ColSimMain::read_checkpoint_records() {
+		_event_record.clear();
 		_plot_points.clear();
 		_emission_record.clear();
-		while (numEvents > 0) {
-			if(generate_event())
-				numEvents--;
+		_final_particles.clear();
+		_final_offsets.resize(1);
+		if (_checkpointed.file_size == 0)
+			return;
+
+		std::string path = checkpoint_records_file();
+		{
+			CheckpointReader in(path);
+			std::vector<Emission> emissions;
+			std::vector<uint> offsets;
+			while (in.position() < _checkpointed.file_size) {
+				uint64_t num_events = in.read<uint64_t>();
+				for (uint64_t i=0; i<num_events; i++)
+					_event_record.push_back(in.read_event());
+				uint64_t num_points = in.read<uint64_t>();
+				for (uint64_t i=0; i<num_points; i++)
+					in.read(_plot_points.emplace_back());
+
+				// offsets count from the start of the whole store
+				in.read(emissions);
+				in.read(offsets);
+				std::span<const Emission> chunk(emissions);
+				uint base = _emission_record.num_emissions(), start = base;
+				for (uint end : offsets) {
+					_emission_record.add_shower(chunk.subspan(start - base, end - start));
+					start = end;
+				}
+
+				uint64_t num_particles = in.read<uint64_t>();
+				for (uint64_t i=0; i<num_particles; i++)
+					_final_particles.push_back(in.read_particle());
+				in.read(offsets);
+				_final_offsets.insert(_final_offsets.end(), offsets.begin(), offsets.end());
+			}
 		}
+
+		bool complete = _event_record.size() == _checkpointed.events && _plot_points.size() == _checkpointed.plot_points
+			&& _emission_record.num_showers() == _checkpointed.showers && _final_particles.size() == _checkpointed.particles
+			&& num_final_states() == _checkpointed.final_states;
+		if (!complete)
+			COLSIM_LOG(LOG_ERROR, "ColSimMain::read_checkpoint_records()", "The records in '{}' do not match checkpoint '{}'", path, _config.checkpoint_file);
+
+		// anything after that is from a checkpoint that was never finished
+		std::error_code error;
+		std::filesystem::resize_file(path, _checkpointed.file_size, error);
+		if (error)
+			COLSIM_LOG(LOG_ERROR, "ColSimMain::read_checkpoint_records()", "Could not truncate '{}': {}", path, error.message());
 	}
 
 
@@ -91,101 +392,328 @@ namespace colsim
 			case PARTON_SHOWERING:
 				generate_event_parton_shower();
 				break;
+			case FULL:
+				generate_event_full();
+				break;
 		}
 	}
 
-	
-	void ColSimMain::stop() {
-		// does nothing at the moment!
-		log(LOG_INFO, "ColSimMain()::stop()", "Stopped event generation!");
+
+	std::vector<double> ColSimMain::reweight(ElectroweakParams const& ew) const {
+		std::vector<double> weights;
+		weights.reserve(_event_record.size());
+
+		for (Event const& event : _event_record) {
+			if (!event.components())
+				COLSIM_LOG(LOG_ERROR, "ColSimMain::reweight()", "Event has no stored components; set 'StoreMEComponents=Yes'.");
+
+			DrellYanComponents const& c = *event.components();
+			weights.push_back(event.weight() * drell_yan_weight(c, ew) / c.terms.total());
+		}
+		return weights;
 	}
 
+	double ColSimMain::reweighted_cross_section(ElectroweakParams const& ew) const {
+		if (_event_record.empty())
+			return _xs;
 
+		// events are distributed according to the nominal weight,
+		// so the mean ratio of weights scales the cross section
+		double ratio_sum = 0.0;
+		for (Event const& event : _event_record) {
+			if (!event.components())
+				COLSIM_LOG(LOG_ERROR, "ColSimMain::reweighted_cross_section()", "Event has no stored components; set 'StoreMEComponents=Yes'.");
 
+			DrellYanComponents const& c = *event.components();
+			ratio_sum += drell_yan_weight(c, ew) / c.terms.total();
+		}
+		return _xs * ratio_sum / static_cast<double>(_event_record.size());
+	}
 
-	bool ColSimMain::generate_event_hard_process() {
-		PhaseSpace phase_space = _hard_process->get_phase_space();
+	
+	void ColSimMain::stop() {
+		if (!_config.result_file.empty()) {
+			run_result().write(_config.result_file);
+			COLSIM_LOG(LOG_INFO, "ColSimMain::stop()", "Wrote the result of the run to '{}'", _config.result_file);
+		}
+		if (!_config.metrics_file.empty()) {
+			metrics().write_json(_config.metrics_file);
+			COLSIM_LOG(LOG_INFO, "ColSimMain::stop()", "Wrote the metrics of the run to '{}'", _config.metrics_file);
+		}
+		if (!_config.trace_file.empty())
+			Tracer::instance().write(_config.trace_file);
+
+		// the run is complete, so its checkpoint could only be resumed by mistake
+		if (checkpointing()) {
+			std::error_code error;
+			std::filesystem::remove(_config.checkpoint_file, error);
+			std::filesystem::remove(checkpoint_records_file(), error);
+			COLSIM_LOG(LOG_INFO, "ColSimMain::stop()", "Removed the checkpoint '{}' of the finished run", _config.checkpoint_file);
+		}
+		COLSIM_LOG(LOG_INFO, "ColSimMain()::stop()", "Stopped event generation!");
+	}
 
-		std::vector<double> phase_space_points;
-		phase_space.fill_phase_space(phase_space_points);
-		std::vector<double> const& deltas = phase_space.deltas();
-		
-		HardProcess::Result res = _hard_process->dsigma(phase_space_points);
-		if (res == HardProcess::Result::invalid_result())
-			return false;
-		
-		double weight = res.weight;
-		// scale the weight
-		for (double d : deltas)
-			weight *= d;
-
-		// hit-or-miss to see if it actually works
-		double weight_ratio = weight/_max_weight;
-		double rand = rand_double();
-
-		while (rand > weight_ratio) {
-			phase_space.fill_phase_space(phase_space_points);
-			res = _hard_process->dsigma(phase_space_points);
-			weight = res.weight;
-			for (double d : deltas)
-				weight *= d;
-
-			// ensure to calculate the new weight and another random number
-			weight_ratio = weight/_max_weight;
-			rand = rand_double();
+	RunResult ColSimMain::run_result() const {
+		RunResult res{};
+		res.process = _config.process;
+		res.mode = flag;
+		res.ecm = _config.ecm;
+		res.seed = _config.seed;
+		res.num_shards = _config.num_shards;
+		res.shards = {_config.shard_index};
+		res.integration = _integration;
+
+		if (_hard_process) {
+			res.num_events = _event_record.size();
+			res.generation_stats = _hard_process->generation_stats();
+
+			// the plotted quantities of the events
+			PhaseSpaceBase const& phase_space = _hard_process->get_phase_space();
+			uint num_plotted = std::min(phase_space.names().size(), phase_space.plot_mins().size());
+			for (uint i=0; i<num_plotted; i++) {
+				Histogram h(phase_space.names()[i], phase_space.plot_mins()[i], phase_space.plot_maxes()[i], HISTOGRAM_BINS);
+				for (std::vector<double> const& point : _plot_points)
+					if (i < point.size())
+						h.fill(point[i]);
+				res.histograms.push_back(std::move(h));
+			}
+		} else {
+			res.num_events = _emission_record.num_showers();
 		}
 
-		// generate a list of particles
-		std::vector<Particle> particles;
-		_hard_process->generate_particles(particles);
-		_event_record.emplace_back(Event(weight, particles));
+		if (_parton_shower) {
+			Histogram log_t("log10(t)", 0.0, VetoStats::LOG10_T_MAX, HISTOGRAM_BINS);
+			Histogram z("z", 0.0, 1.0, HISTOGRAM_BINS);
+			for (Emission const& e : _emission_record.emissions()) {
+				log_t.fill(std::log10(e.t));
+				z.fill(e.z);
+			}
+			res.histograms.push_back(std::move(log_t));
+			res.histograms.push_back(std::move(z));
+		}
+		return res;
+	}
 
-		// plot the phase space points and the chosen additional values
-		std::vector<double> plot_points(phase_space_points.begin(), phase_space_points.end());
-		plot_points.append_range(res.additional_vals);
-		_plot_points.emplace_back(plot_points);
 
-		return true;
+
+
+	bool ColSimMain::generate_event_hard_process() {
+		return _hard_process->generate(1, _max_weight, _event_record, _plot_points, _rng) == 1;
 	}
 
-	bool ColSimMain::generate_event_parton_shower() {
-	    double Q0 = SETTINGS.initial_evol_e;
-		double Qf = SETTINGS.evol_energy_cutoff;
+	double ColSimMain::shower_alphas_over() const {
+	    double Q0 = _config.initial_evol_e;
+		double Qf = _config.evol_energy_cutoff;
 		
 		double scale;
-		if (SETTINGS.fixed_scale)
+		if (_config.fixed_scale)
 			scale = Q0/2.0;
 		else {
 			scale = Qf;
 		}
 
 		AlphaS const& as = _parton_shower->alphas();
-		_emission_record.emplace_back(_parton_shower->evolve(Q0, Qf, as.alphas_over(scale)));
+		return as.alphas_over(scale);
+	}
+
+	void ColSimMain::log_veto_stats() const {
+		VetoStats stats = _parton_shower->veto_stats();
+		VetoStats::Counts total = stats.total();
+		COLSIM_LOG(LOG_INFO, "ColSimMain::log_veto_stats()",
+			"Accepted {:.2f}% of {} trial emissions ({} vetoed by the splitting function, {} by alpha_s)",
+			100.0*total.acceptance_rate(), total.trials, total.splitting_vetoes, total.alphas_vetoes);
+
+		// regions with only a handful of trials say little
+		constexpr unsigned long MIN_TRIALS = 100;
+		uint worst_t = 0, worst_z = 0;
+		double worst = 2.0;
+		for (uint i=0; i<VetoStats::NUM_T_BINS; i++) {
+			for (uint j=0; j<VetoStats::NUM_Z_BINS; j++) {
+				VetoStats::Counts const& c = stats.at(i, j);
+				if (c.trials >= MIN_TRIALS && c.acceptance_rate() < worst) {
+					worst = c.acceptance_rate();
+					worst_t = i;
+					worst_z = j;
+				}
+			}
+		}
+		if (worst <= 1.0) {
+			double dlog_t = VetoStats::LOG10_T_MAX/VetoStats::NUM_T_BINS;
+			COLSIM_LOG(LOG_DEBUG, "ColSimMain::log_veto_stats()",
+				"Lowest acceptance {:.2f}% at log10(t) in [{:.1f}, {:.1f}), z in [{:.1f}, {:.1f})",
+				100.0*worst, worst_t*dlog_t, (worst_t+1)*dlog_t,
+				static_cast<double>(worst_z)/VetoStats::NUM_Z_BINS, static_cast<double>(worst_z+1)/VetoStats::NUM_Z_BINS);
+		}
+	}
+
+	bool ColSimMain::generate_event_parton_shower() {
+		_parton_shower->evolve(_config.initial_evol_e, _config.evol_energy_cutoff, shower_alphas_over(), _emission_record, _rng);
 		return true;
 	}
 
 
-	void ColSimMain::start_hard_process() {
-		// ensure to reset ranges in the event that
-		// we have changed a config file variable between calculations
-		_hard_process->get_phase_space().set_ranges();
-		
-		log(LOG_INFO, "ColSimMain::start_hard_process()", "Calculating cross section via Monte Carlo integration...");
-		HardProcessResult res = _hard_process->calculate();
-		log(LOG_INFO, "ColSimMain::start_hard_process()", 
-			"Result is: {:.9f} +- {:.9f} pb (picobarns)", res.result, res.error);
+	uint ColSimMain::assign_showers(Event& event, uint first, std::vector<double>& scales, std::vector<PartonKind>& kinds) {
+		uint count = 0;
+		for (Particle const& p : event.particles()) {
+			// incoming partons would need backwards evolution
+			if (!p.is_coloured() || p.is_incoming())
+				continue;
+			scales.push_back(event.Q());
+			kinds.push_back(p.pid() == 21 ? PartonKind::GLUON : PartonKind::QUARK);
+			count++;
+		}
+		event.set_showers(first, count);
+		return count;
+	}
+
+	bool ColSimMain::generate_event_full() {
+		if (!generate_event_hard_process())
+			return false;
+
+		std::vector<double> scales;
+		std::vector<PartonKind> kinds;
+		assign_showers(_event_record.back(), _emission_record.num_showers(), scales, kinds);
+
+		_parton_shower->evolve_batch(scales, _config.evol_energy_cutoff, shower_alphas_over(), _emission_record, _rng, kinds);
+		reconstruct_final_states(_event_record.size() - 1);
+		return true;
+	}
+
+	void ColSimMain::generate_events_full(uint num_events) {
+		struct ShowerJob
+		{
+			uint index;
+			std::vector<double> scales;
+			std::vector<PartonKind> kinds;
+		};
+
+		uint first_event = _event_record.size();
+		uint num_jobs = (num_events + PIPELINE_CHUNK_SIZE - 1) / PIPELINE_CHUNK_SIZE;
+		uint num_workers = std::max(1u, _config.num_threads - 1);
+		BoundedQueue<ShowerJob> queue(PIPELINE_QUEUE_DEPTH*num_workers);
+
+		// each chunk gets its own store and random number stream, so the
+		// result does not depend on which thread happened to shower it
+		std::vector<EmissionStore> showers(num_jobs);
+		uint64_t seed = _rng();
+		double Qmin = _config.evol_energy_cutoff;
+		double alphas_over = shower_alphas_over();
+
+		// time spent in pop() and push() is time the workers
+		// waited for hard processes, or the other way round
+		auto next_job = [&]() {
+			TraceScope trace("wait for job", "queue");
+			return queue.pop();
+		};
+		auto consume = [&]() {
+			Tracer::instance().name_thread("shower worker");
+			while (std::optional<ShowerJob> job = next_job()) {
+				TraceScope trace("shower", "shower", "chunk", job->index);
+				Random rng(seed, job->index);
+				_parton_shower->evolve_batch(job->scales, Qmin, alphas_over, showers[job->index], rng, job->kinds);
+			}
+		};
+
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(num_workers);
+			for (uint i=0; i<num_workers; i++)
+				workers.emplace_back(consume);
+
+			// the hard process is generated here, since it keeps
+			// state (the envelope, the statistics) between batches
+			std::vector<double> scales;
+			std::vector<PartonKind> kinds;
+			uint next_shower = _emission_record.num_showers();
+			for (uint job=0; job<num_jobs; job++) {
+				uint first = _event_record.size();
+				uint n = std::min(PIPELINE_CHUNK_SIZE, num_events - job*PIPELINE_CHUNK_SIZE);
+				{
+					TraceScope trace("hard process", "generation", "chunk", job);
+					_hard_process->generate(n, _max_weight, _event_record, _plot_points, _rng);
+					for (uint e=first; e<_event_record.size(); e++)
+						next_shower += assign_showers(_event_record[e], next_shower, scales, kinds);
+				}
+				TraceScope trace("wait for worker", "queue", "chunk", job);
+				queue.push(ShowerJob{job, std::move(scales), std::move(kinds)});
+				scales = {};
+				kinds = {};
+			}
+			queue.close();
+		}
+
+		{
+			TraceScope trace("merge showers", "output", "chunks", num_jobs);
+			for (EmissionStore const& store : showers)
+				_emission_record.append(store);
+		}
+		reconstruct_final_states(first_event);
+	}
+
+	void ColSimMain::reconstruct_final_states(uint first_event) {
+		uint num_events = _event_record.size() - first_event;
+		TraceScope trace("final states", "output", "events", num_events);
+		// every emission of the events' showers adds one particle
+		std::span<const uint> offsets = _emission_record.offsets();
+		size_t num_particles = 0;
+		for (uint e=first_event; e<_event_record.size(); e++) {
+			Event const& event = _event_record[e];
+			num_particles += event.particles().size();
+			if (event.num_showers() > 0)
+				num_particles += offsets[event.first_shower() + event.num_showers()] - offsets[event.first_shower()];
+		}
+		reserve_more(_final_particles, num_particles);
+		reserve_more(_final_offsets, num_events);
+		uint failed = 0;
+		for (uint e=first_event; e<_event_record.size(); e++) {
+			if (!_kinematics.reconstruct(_event_record[e], _emission_record, _rng, _final_particles))
+				failed++;
+			_final_offsets.push_back(_final_particles.size());
+		}
+		if (failed > 0)
+			COLSIM_LOG(LOG_WARNING, "ColSimMain::reconstruct_final_states()",
+				"Showers of {} of {} events carried more mass than the event had energy and were dropped.", failed, num_events);
+	}
 
-		_xs = res.result;
-		_xs_error = res.error;
-		_max_weight = res.max_weight;
-		_max_ps_points = res.max_points;
 
-		log(LOG_INFO, "ColSimMain::start_hard_process()", "Maximum weight achieved: {:.9f}", _max_weight);
+	void ColSimMain::start_hard_process() {
+		if (_stage == RunStage::INTEGRATION) {
+			COLSIM_LOG(LOG_INFO, "ColSimMain::start_hard_process()", "Calculating cross section via Monte Carlo integration...");
+
+			uint64_t total = _config.num_iterations;
+			uint interval = checkpointing() ? _config.checkpoint_interval : _config.num_iterations;
+			while (_integration.iterations < total) {
+				uint n = std::min<uint64_t>(interval, total - _integration.iterations);
+				{
+					TraceScope trace("integrate", "integration", "iterations", n);
+					_hard_process->integrate(_integration, n, _rng);
+				}
+				if (checkpointing() && _integration.iterations < total)
+					write_checkpoint();
+			}
+			HardProcessResult res = _hard_process->finish_integration(_integration);
+
+			_xs = res.result;
+			_xs_error = res.error;
+			_max_weight = res.max_weight;
+			_max_ps_points = res.max_points;
+
+			_stage = RunStage::GENERATION;
+			if (checkpointing())
+				write_checkpoint();
+		} else {
+			COLSIM_LOG(LOG_INFO, "ColSimMain::start_hard_process()", "Taking the cross section from the checkpoint.");
+		}
+
+		COLSIM_LOG(LOG_INFO, "ColSimMain::start_hard_process()", 
+			"Result is: {:.9f} +- {:.9f} pb (picobarns)", _xs, _xs_error);
+		COLSIM_LOG(LOG_INFO, "ColSimMain::start_hard_process()", "Maximum weight achieved: {:.9f}", _max_weight);
 	}
 
 	void ColSimMain::start_parton_shower() {
 		// nothing else to initialize
-		log(LOG_INFO, "ColSimMain::start_parton_shower()", "Starting parton shower event generation.");
+		_stage = RunStage::GENERATION;
+		COLSIM_LOG(LOG_INFO, "ColSimMain::start_parton_shower()", "Starting parton shower event generation.");
 	}
 
 	void ColSimMain::generate_plots_hard_process()
@@ -195,7 +723,7 @@ namespace colsim
 
 	/*
 	void ColSimMain::generate_plots_hard_process() {
-		log(LOG_INFO, "", "Generating plots...");
+		COLSIM_LOG(LOG_INFO, "", "Generating plots...");
 
 		PhaseSpace& phase_space = _hard_process->get_phase_space();
 
@@ -226,19 +754,17 @@ namespace colsim
 		const std::vector<std::string> plotNames{"t", "pT", "m"};
 
 		std::vector<Double> v;
-	    for (const std::vector<PartonShower::Emission>& emissions : emissionRecord) {
-			for (const PartonShower::Emission& e : emissions) {
-				v.push_back(std::sqrt(e.t));
-				v.push_back(std::sqrt(e.pT_2));
-				v.push_back(std::sqrt(e.m_2));
-				plotPoints.emplace_back(v);
-				v.clear();
-			}
+		for (const Emission& e : emissionRecord.emissions()) {
+			v.push_back(std::sqrt(e.t));
+			v.push_back(std::sqrt(e.pT_2));
+			v.push_back(std::sqrt(e.m_2));
+			plotPoints.emplace_back(v);
+			v.clear();
 		}
 
 		// maximum for t is directly cutoff at this value,
 		// so we can fix it here
-		double tMax = std::sqrt(SETTINGS.initialEvolEnergy);
+		double tMax = std::sqrt(_config.initialEvolEnergy);
 		
 		std::vector<Double>
 			min{0.0, 0.0, 0.0},
@@ -0,0 +1,51 @@
+#include "colsim/electroweak.hpp"
+
+#include <cmath>
+
+#include "colsim/common.hpp"
+
+namespace colsim
+{
+	DrellYanTerms drell_yan_terms(DrellYanComponents const& c, ElectroweakParams const& ew)
+	{
+		double s_hat = c.s_hat;
+		double mz_2 = ew.z_mass*ew.z_mass;
+		double width_2 = ew.z_width*ew.z_width;
+
+		// propagator factors
+		double kappa = std::sqrt(2.0)*FERMI_CONSTANT*mz_2 / (4.0*PI*ALPHA);
+		double denom = std::pow(s_hat-mz_2,2) + width_2*mz_2;
+		double chi1 = kappa*s_hat*(s_hat-mz_2) / denom;
+		double chi2 = kappa*kappa*s_hat*s_hat / denom;
+
+		// lepton couplings
+		double CAe = -0.5, CVe = -0.5 + 2.0*ew.sin2_theta_w;
+
+		// quark couplings, up-type then down-type
+		std::array<double, 2> CVf{0.5 - (4.0/3.0)*ew.sin2_theta_w, -0.5 + (2.0/3.0)*ew.sin2_theta_w};
+		std::array<double, 2> CAf{0.5, -0.5};
+		std::array<double, 2> Qf{2.0/3.0, -1.0/3.0};
+
+		double cos_theta = c.cos_theta;
+		double norm = c.prefactor * 2.0*PI*ALPHA*ALPHA / (4.0*3.0*s_hat);
+
+		DrellYanTerms terms{0.0, 0.0, 0.0};
+		for (uint q=0; q<2; q++) {
+			// the symmetric part goes with a0 and the antisymmetric part with a1
+			double sym  = (1.0 + cos_theta*cos_theta) * (c.lumi_fwd[q] + c.lumi_bwd[q]);
+			double asym = cos_theta * (c.lumi_fwd[q] - c.lumi_bwd[q]);
+
+			terms.gamma        += sym * Qf[q]*Qf[q];
+			terms.interference += sym * (-2.0*Qf[q]*CVe*CVf[q]*chi1)
+				                + asym * (-4.0*Qf[q]*CAe*CAf[q]*chi1);
+			terms.z            += sym * (CAe*CAe + CVe*CVe)*(CAf[q]*CAf[q] + CVf[q]*CVf[q])*chi2
+				                + asym * 8.0*CAe*CVe*CAf[q]*CVf[q]*chi2;
+		}
+
+		terms.gamma *= norm;
+		terms.interference *= norm;
+		terms.z *= norm;
+		return terms;
+	}
+
+}; // namespace ColSim
@@ -3,149 +3,46 @@
 #include <cmath>
 #include <memory>
 
-#include "LHAPDF/LHAPDF.h"
-
 #include "colsim/utils.hpp"
-#include "colsim/settings.hpp"
 #include "colsim/math.hpp"
 #include "colsim/common.hpp"
 #include "colsim/phase_space.hpp"
 
 namespace colsim
 {
-	HardProcessResult HardProcess::calculate()
+	HardProcess::HardProcess(RunConfig const& config)
+		: _ecm{config.ecm}, _s{config.s}, _pdf{config.pdf}, _num_iterations{static_cast<uint>(config.num_iterations)}
 	{
-		uint num_dims = _phase_space->dims();
-		
-		double weight_sum = 0.0F;
-		double weight_squared_sum = 0.0F;
-
-		HardProcessResult res(num_dims);
-		
-	    // setup vector for phase space points
-		std::vector<double> points;
-
-		// here we get delta values which we need for Monte Carlo
-	    const std::vector<double>& deltas = _phase_space->deltas();
-		
-		for (int i=0; i<SETTINGS.num_iterations; i++) {
-			_phase_space->fill_phase_space(points);
-			
-			Result dsigma_res = dsigma(points);
-
-			// if it is invalid, we must redo
-			if (dsigma_res == Result::invalid_result()) {
-				i--;
-				continue;
-			}
-			
-			double weight = dsigma_res.weight;
-    
-			// multiply by the deltas of the independent variables
-			for (uint j=0; j<num_dims; j++)
-			    weight *= deltas[j];
-
-			// add to total weight
-			weight_sum += weight;
-			weight_squared_sum += pow(weight, 2);
-
-			// set maxes
-			if (weight > res.max_weight) {
-				res.max_weight = weight;
-				for (uint j=0; j<num_dims; j++)
-					res.max_points[j] = points[j];
-			}
-		}
-
-		// doing divisions, so we want a Double
-		double num_evals = static_cast<double>(SETTINGS.num_iterations);
-		
-		res.result = weight_sum/num_evals;
-		double variance = weight_squared_sum/num_evals
-			              - std::pow(weight_sum/num_evals,2);
-		res.error = std::sqrt(variance/num_evals);
-
-		// scale to picobarns
-		res.result *= MAGIC_FACTOR;
-		res.error *= MAGIC_FACTOR;
-		
-		return res;
+		if (!_pdf)
+			COLSIM_LOG(LOG_ERROR, "HardProcess::HardProcess()", "The configuration has no PDF set.");
+		_pdf->load();
 	}
 
 
+	PP2Zg2ll::PP2Zg2ll(RunConfig const& config)
+		: HardProcessImpl(config), _trans_energy_2{config.trans_energy_2}, _store_components{config.store_me_components}
+	{}
 
-	
-
-	PP2Zg2ll::PP2Zg2ll() {
-		_phase_space = std::unique_ptr<PhaseSpace>(new PhaseSpace_TauYCosth());
-	}
-	
-	double PP2Zg2ll::kappa() const {
-		return std::sqrt(2.0)*FERMI_CONSTANT*Z_MASS_2 / (4.0*PI*ALPHA);
-	}
-
-	double PP2Zg2ll::chi1(const double s_hat) const {
-		return kappa()*s_hat*(s_hat-Z_MASS_2) / (std::pow(s_hat-Z_MASS,2) + Z_WIDTH_2*Z_MASS_2);
-	}
-	
-	double PP2Zg2ll::chi2(const double s_hat) const {
-		return std::pow(kappa(),2) * std::pow(s_hat,2) / (std::pow(s_hat-Z_MASS_2,2) + Z_WIDTH_2*Z_MASS_2);
-	}
-	
-	double PP2Zg2ll::a0(uint quarkType, double s_hat) const {
-		double CAe = -0.5, CVe = -0.5 + 2.0*WEINBERG_ANGLE;
-		double CVf, CAf, Qf;
-		if (quarkType == 0) { // up-type
-			CVf = 0.5 - (4.0/3.0)*WEINBERG_ANGLE;
-			CAf = 0.5;
-			Qf = 2.0/3.0;
-		} else { // down-type
-			CVf = -0.5 + (2.0/3.0)*WEINBERG_ANGLE;
-			CAf = -0.5;
-			Qf = -1.0/3.0;
-		}
-
-	    return Qf*Qf - 2.0*Qf*CVe*CVf*chi1(s_hat) + (CAe*CAe + CVe*CVe)*(CAf*CAf + CVf*CVf) * chi2(s_hat);
-	}
-	
-	double PP2Zg2ll::a1(uint quarkType, double s_hat) const {
-		double A_mu = -0.5, V_mu = -0.5 + 2.0*WEINBERG_ANGLE;
-		double V_quark, A_quark, Q_quark;
-		if (quarkType == 0) { // up-type
-			V_quark = 0.5 -(4.0/3.0)*WEINBERG_ANGLE;
-			A_quark = 0.5;
-			Q_quark = 2.0/3.0;
-		} else {
-			V_quark = -0.5 + (2.0/3.0)*WEINBERG_ANGLE;
-			A_quark = -0.5;
-			Q_quark = -1.0/3.0;
-		}
-
-	    return -4.0*Q_quark*A_mu*A_quark*chi1(s_hat) + 8.0*A_mu*V_mu*A_quark*V_quark*chi2(s_hat);
-	}
-
-
-	double PP2Zg2ll::dsigma_hat(double cosTheta, uint quarkType, double s_hat) {
-		return (2.0*PI*std::pow(ALPHA,2) / (4.0*3.0*s_hat)) * (a0(quarkType,s_hat)*(1.0 + std::pow(cosTheta,2)) + a1(quarkType,s_hat)*cosTheta);
-	}
-
-	double PP2Zg2ll::compute_weight(double s_hat, double x1, double x2, double cosTheta) {
-		double weight = 0.0;
-		LHAPDF::PDF& pdf = *SETTINGS.pdf;
+	void PP2Zg2ll::compute_luminosities(DrellYanComponents& c, double x1, double x2) {
+		PDFSet const& pdf = *_pdf;
+		double s_hat = c.s_hat;
+		// every lookup is counted where it is made
+		auto xf = [&](int id, double x) {
+			_pdf_calls++;
+			return pdf.xfxQ2(id, x, s_hat);
+		};
 		// up-type quarks
-		weight += dsigma_hat(cosTheta , 0, s_hat) * ((pdf.xfxQ2(2 , x1, s_hat) * pdf.xfxQ2(-2, x2, s_hat)) + (pdf.xfxQ2(4 , x1, s_hat) * pdf.xfxQ2(-4, x2, s_hat)));	
-		weight += dsigma_hat(-cosTheta, 0, s_hat) * ((pdf.xfxQ2(-2, x1, s_hat) * pdf.xfxQ2(2 , x2, s_hat)) + (pdf.xfxQ2(-4, x1, s_hat) * pdf.xfxQ2(4 , x2, s_hat)));
+		c.lumi_fwd[0] = (xf(2 , x1) * xf(-2, x2)) + (xf(4 , x1) * xf(-4, x2));
+		c.lumi_bwd[0] = (xf(-2, x1) * xf(2 , x2)) + (xf(-4, x1) * xf(4 , x2));
 		// down-type quarks
-		weight += dsigma_hat(cosTheta , 1, s_hat) * ((pdf.xfxQ2(1 , x1, s_hat) * pdf.xfxQ2(-1, x2, s_hat)) + (pdf.xfxQ2(3 , x1, s_hat) * pdf.xfxQ2(-3, x2, s_hat)));
-		weight += dsigma_hat(-cosTheta, 1, s_hat) * ((pdf.xfxQ2(-1, x1, s_hat) * pdf.xfxQ2(1 , x2, s_hat)) + (pdf.xfxQ2(-3, x1, s_hat) * pdf.xfxQ2(3 , x2, s_hat)));
-
-		return weight;
+		c.lumi_fwd[1] = (xf(1 , x1) * xf(-1, x2)) + (xf(3 , x1) * xf(-3, x2));
+		c.lumi_bwd[1] = (xf(-1, x1) * xf(1 , x2)) + (xf(-3, x1) * xf(3 , x2));
 	}
 
 
-	HardProcess::Result PP2Zg2ll::dsigma( std::vector<double> const& phaseSpacePoints) {
-		double S = SETTINGS.s;
-		double E_TR_2 = SETTINGS.trans_energy_2;
+	HardProcess::Result PP2Zg2ll::dsigma(std::span<const double, num_dims> phaseSpacePoints) {
+		double S = _s;
+		double E_TR_2 = _trans_energy_2;
 
 		// independent variables
 		double cos_theta = phaseSpacePoints[0];
@@ -165,27 +62,29 @@ namespace colsim
 		double x2 = std::sqrt(s_hat/S)*std::exp(-y);
 
 		if ((x1 > 1.0 || x1 < 0.0) || (x2 > 1.0 || x2 <0.0)) {
-			log(LOG_WARNING, "PP2Zg2ll::dsigma()", "Encountered invalid x1 or x2: ({:.4f},{:.4f}). Retrying...", x1, x2);
+			static LogLimit invalid_x;
+			COLSIM_LOG_LIMITED(invalid_x, LOG_WARNING, "PP2Zg2ll::dsigma()", "Encountered invalid x1 or x2: ({:.4f},{:.4f}). Retrying...", x1, x2);
 			return Result::invalid_result();
 		}
 
-		double weight = compute_weight(s_hat, x1, x2, cos_theta);
 		// go ahead and scale it this way here
-		weight *= (jacobian * deltay);
-		weight /= (x1 * x2);
+		DrellYanComponents components{s_hat, cos_theta, (jacobian * deltay) / (x1 * x2), {}, {}, {}};
+		compute_luminosities(components, x1, x2);
+		components.terms = drell_yan_terms(components, _ew);
 
 		// pass through the COM energy and the momentum fraction (x1)
-		return HardProcess::Result(weight, {std::sqrt(s_hat), x1});
+		HardProcess::Result res(components.terms.total(), {std::sqrt(s_hat), x1});
+		res.scale = std::sqrt(s_hat);
+		if (_store_components)
+			res.components = components;
+		return res;
 	}
 
 
-	void PP2Zg2ll::generate_particles(std::vector<Particle>& particles) {
-		double S = SETTINGS.s;
-		double ECM = SETTINGS.ecm;
-		double E_TR_2 = SETTINGS.trans_energy_2;
-
-		std::vector<double> phaseSpacePoints;
-		_phase_space->fill_phase_space(phaseSpacePoints);
+	void PP2Zg2ll::generate_particles(std::span<const double, num_dims> phaseSpacePoints, std::vector<Particle>& particles, Random& rng) {
+		double S = _s;
+		double ECM = _ecm;
+		double E_TR_2 = _trans_energy_2;
 
 		double cos_theta = phaseSpacePoints[0];
 		double rho      = phaseSpacePoints[1];
@@ -204,17 +103,17 @@ namespace colsim
 		// boost parameter
 		double beta = (x2-x1)/(x2+x1);
 		// more phase space points
-		double phi = rand_double()*2.0*M_PI;
+		double phi = rng.uniform()*2.0*M_PI;
 		double sinPhi = std::sin(phi);
 		double cosPhi = std::cos(phi);
 		double sinTheta = std::sqrt(1.0 - cos_theta*cos_theta);
 
 		particles.emplace_back(
 			FourVector{0.5*x1*ECM, 0.0, 0.0, 0.5*x1*ECM},
-			1, "q1");
+			1, "q1", ParticleStatus::INCOMING);
 		particles.emplace_back(
 			FourVector{0.5*x2*ECM, 0.0, 0.0, -0.5*x2*ECM},
-			1, "q2");
+			1, "q2", ParticleStatus::INCOMING);
 		particles.emplace_back(
 			FourVector{0.5*Q, 0.5*Q*sinTheta*cosPhi, 0.5*Q*sinTheta*sinPhi, 0.5*Q*cos_theta}.zboost(beta),
 			13, "l1");
@@ -227,157 +126,250 @@ namespace colsim
 
 
 
-	PP2Jets::PP2Jets() {
-		_phase_space = std::unique_ptr<PhaseSpace>(new PhaseSpace_EtEta());
-	}
+	PP2Jets::PP2Jets(RunConfig const& config)
+		: HardProcessImpl(config), _xf1(13, 0.0), _xf2(13, 0.0)
+	{
 
+		// sort every pair of incoming flavours into its channel once,
+		// so that dsigma() only has to sum luminosities
+		for (uint i=0; i<NUM_FLAVOURS; i++) {
+			for (uint j=0; j<NUM_FLAVOURS; j++) {
+				int pid1 = static_cast<int>(i) - static_cast<int>(NF);
+				int pid2 = static_cast<int>(j) - static_cast<int>(NF);
+
+				if (pid1 == 0 && pid2 == 0)
+					_channel_map[i][j] = GG;
+				else if (pid1 == 0 || pid2 == 0)
+					_channel_map[i][j] = QG;
+				else if (pid1 == pid2)
+					_channel_map[i][j] = QQ;
+				else if (pid1 == -pid2)
+					_channel_map[i][j] = QQBAR;
+				else
+					_channel_map[i][j] = QQPRIME;
+			}
+		}
+	}
 
-	double PP2Jets::qqprime2qqprime(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
 
-		return (4*M_PI*alpha_s*alpha_s)/(9.0*s*s) * ((s*s +  u*u)/(t*t));
-	}
-	double PP2Jets::qqprimebar2qqprimebar(double eta3, double eta4, double E_t, double alpha_s) {
-		return qqprime2qqprime(eta3, eta4, E_t, alpha_s);
+	double PP2Jets::qqprime2qqprime(double s, double t, double u) {
+		return (4.0/9.0) * (s*s + u*u)/(t*t);
 	}
 
 	// scattering of identical quarks
-	double PP2Jets::qq2qq(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
-
-		return (4.0*M_PI*alpha_s*alpha_s)/(9.0*s*s) * ((s*s + u*u)/(t*t) + (t*t + u*u)/(s*s) - (2.0/3.0)*((s*s)/(u*t)));
+	double PP2Jets::qq2qq(double s, double t, double u) {
+		return (4.0/9.0) * ((s*s + u*u)/(t*t) + (s*s + t*t)/(u*u)) - (8.0/27.0)*(s*s)/(u*t);
 	}
 
-	double PP2Jets::qqbar2qprimeqprimebar(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
-
-
-		return (4.0*M_PI*alpha_s*alpha_s)/(9.0*s*s) * ((t*t + u*u)/(s*s));
+	double PP2Jets::qqbar2qqbar(double s, double t, double u) {
+		return (4.0/9.0) * ((s*s + u*u)/(t*t) + (t*t + u*u)/(s*s)) - (8.0/27.0)*(u*u)/(s*t);
 	}
 
+	double PP2Jets::qqbar2qprimeqprimebar(double s, double t, double u) {
+		return (4.0/9.0) * (t*t + u*u)/(s*s);
+	}
 
-	double PP2Jets::gg2gg(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
+	double PP2Jets::gg2gg(double s, double t, double u) {
+		return (9.0/2.0) * (3.0 - (t*u)/(s*s) - (s*u)/(t*t) - (s*t)/(u*u));
+	}
 
-		return (9.0*M_PI*alpha_s*alpha_s) / (2.0 * s*s) * (3 - (t*u)/(s*s) - (s*u)/(t*t) - (s*t)/(u*u));
-    
+	double PP2Jets::qqbar2gg(double s, double t, double u) {
+		return (32.0/27.0) * (u/t + t/u) - (8.0/3.0)*((t*t + u*u)/(s*s));
 	}
-	double PP2Jets::qqbar2gg(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
 
-		return (32.0*M_PI*alpha_s*alpha_s)/(27.0*s*s) * (u/t + t/u - (9.0/4.0)*((t*t + u*u)/(s*s)));
+	double PP2Jets::gg2qqbar(double s, double t, double u) {
+		return (1.0/6.0) * (u/t + t/u) - (3.0/8.0)*((t*t + u*u)/(s*s));
 	}
-	double PP2Jets::gg2qqbar(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
 
-		return (M_PI * alpha_s*alpha_s)/(6*s*s) * (u/t + t/u - (9.0/4.0)*((t*t + u*u)/(s*s)));
+	double PP2Jets::qg2qg(double s, double t, double u) {
+		return -(4.0/9.0) * (s/u + u/s) + (s*s + u*u)/(t*t);
 	}
 
-	double PP2Jets::qg2qg(double eta3, double eta4, double E_t, double alpha_s) {
-		double eta_star = calc_eta_star(eta3, eta4);
-		double s = calc_sh(eta_star, E_t);
-		double t = calc_th(eta_star, E_t);
-		double u = calc_uh(eta_star, E_t);
 
-		return (4.0*M_PI*alpha_s*alpha_s)/(9*s*s) * (-u/s - s/u + (9.0/4.0)*((s*s + u*u)/(t*t)));
+	std::array<double, PP2Jets::NUM_CHANNELS> PP2Jets::channel_cross_sections(double s, double t, double u, double alphas) const {
+		double norm = PI*alphas*alphas / (s*s);
+		double nf = static_cast<double>(NF);
+
+		// the two jets are distinguished only by their rapidity,
+		// so distinct final states get both the (t,u) and (u,t) assignments
+		std::array<double, NUM_CHANNELS> xs;
+		xs[QQPRIME] = qqprime2qqprime(s, t, u) + qqprime2qqprime(s, u, t);
+		xs[QQ]      = qq2qq(s, t, u);
+		xs[QQBAR]   = qqbar2qqbar(s, t, u) + qqbar2qqbar(s, u, t)
+			        + (nf - 1.0)*(qqbar2qprimeqprimebar(s, t, u) + qqbar2qprimeqprimebar(s, u, t))
+			        + qqbar2gg(s, t, u);
+		xs[GG]      = gg2gg(s, t, u) + nf*(gg2qqbar(s, t, u) + gg2qqbar(s, u, t));
+		xs[QG]      = qg2qg(s, t, u) + qg2qg(s, u, t);
+
+		for (double& x : xs)
+			x *= norm;
+		return xs;
 	}
 
 
-	HardProcess::Result PP2Jets::dsigma(std::vector<double> const& phaseSpacePoints) {
+	HardProcess::Result PP2Jets::dsigma(std::span<const double, num_dims> phaseSpacePoints) {
 		double Et = phaseSpacePoints[0];
 		double eta3 = phaseSpacePoints[1];
 
-		// retrieve/calculate quantities required to grab PDF data
-		double S = SETTINGS.s;
-		LHAPDF::PDF& pdf = *SETTINGS.pdf;
-		double alphaS = pdf.alphasQ2(S);
 		double x1 = calc_x1(eta3, _eta4, Et);
 		double x2 = calc_x2(eta3, _eta4, Et);
-		const std::vector<uint> pids{1, 2, 3, 4, 5, 21}; // vector of PDG IDs for all quarks (but top) and gluon
-
-		// must add all processes
-		double total = 0.0;
 
-		// q + q' -> q + q'
-		double total_qqprime2qqprime = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			for (int j=i+1; i<pids.size(); i++) {
-				total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[j], x2, S)
-					* (1.0/M_PI)*qqprime2qqprime(eta3, _eta4, Et, alphaS);
-			}
+		// beyond the kinematic limit there is simply nothing
+		if (x1 >= 1.0 || x2 >= 1.0)
+			return Result(0.0);
+
+		// kinematics, computed once for all channels
+		double eta_star = calc_eta_star(eta3, _eta4);
+		double s = calc_sh(eta_star, Et);
+		double t = calc_th(eta_star, Et);
+		double u = -s - t;
+
+		// evaluate everything at the scale of the jets
+		double Q2 = Et*Et;
+		PDFSet const& pdf = *_pdf;
+		double alphas = pdf.alphasQ2(Q2);
+
+		// one call per proton for all flavours, ordered by PDG ID from -6 to 6
+		pdf.xfxQ2(x1, Q2, _xf1);
+		pdf.xfxQ2(x2, Q2, _xf2);
+		_pdf_calls += 2;
+
+		// contract the densities into a luminosity per channel
+		std::array<double, NUM_CHANNELS> lumi{};
+		for (uint i=0; i<NUM_FLAVOURS; i++) {
+			double xf1 = _xf1[i+1];
+			for (uint j=0; j<NUM_FLAVOURS; j++)
+				lumi[_channel_map[i][j]] += xf1 * _xf2[j+1];
 		}
-		total += total_qqprime2qqprime;
 
-		// q + q -> q + q
-		double total_qq2qq = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[i], x2, S)
-				* (1.0/M_PI)*qq2qq(eta3, _eta4, Et, alphaS);
-		}
-		total += total_qq2qq;
-
-		// q + qb -> q' + qb'
-		double total_qqbar2qprimeqprimebar = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[i], x2, S)
-				* (1.0/M_PI)*qqbar2qprimeqprimebar(eta3, _eta4, Et, alphaS);
-		}
-		total += total_qqbar2qprimeqprimebar;
+		std::array<double, NUM_CHANNELS> xs = channel_cross_sections(s, t, u, alphas);
+		double total = 0.0;
+		for (uint c=0; c<NUM_CHANNELS; c++)
+			total += lumi[c] * xs[c];
 
-		
-		// g + g -> g + g
-	    total += pdf.xfxQ2(21, x1, S) * pdf.xfxQ2(21, x2, S) * gg2gg(eta3, _eta4, Et, alphaS);
+		total *= 2.0*Et;
+		Result res(total);
+		res.scale = Et;
+		return res;
+	}
 
-		// q + qb -> g + g
-		double total_qqbar2gg = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[i], x2, S)
-				* (1.0/M_PI)*qqbar2gg(eta3, _eta4, Et, alphaS);
+	std::pair<int, int> PP2Jets::outgoing_flavours(int pid1, int pid2, double s, double t, double u, Random& rng) const {
+		// every final state the channel sums over, in the same order
+		struct Candidate
+		{
+			double weight;
+			int pid3, pid4;
+		};
+		std::array<Candidate, 2*NF + 2> candidates;
+		uint n = 0;
+		auto add = [&](double weight, int pid3, int pid4) { candidates[n++] = Candidate{weight, pid3, pid4}; };
+
+		int nf = static_cast<int>(NF);
+		switch (_channel_map[pid1 + nf][pid2 + nf]) {
+			case QQPRIME:
+				add(qqprime2qqprime(s, t, u), pid1, pid2);
+				add(qqprime2qqprime(s, u, t), pid2, pid1);
+				break;
+			case QQ:
+				add(qq2qq(s, t, u), pid1, pid2);
+				break;
+			case QQBAR:
+			{
+				add(qqbar2qqbar(s, t, u), pid1, pid2);
+				add(qqbar2qqbar(s, u, t), pid2, pid1);
+				int sign = pid1 > 0 ? 1 : -1;
+				for (int f=1; f<=nf; f++) {
+					if (f == std::abs(pid1))
+						continue;
+					add(qqbar2qprimeqprimebar(s, t, u), sign*f, -sign*f);
+					add(qqbar2qprimeqprimebar(s, u, t), -sign*f, sign*f);
+				}
+				add(qqbar2gg(s, t, u), 0, 0);
+				break;
+			}
+			case GG:
+				add(gg2gg(s, t, u), 0, 0);
+				for (int f=1; f<=nf; f++) {
+					add(gg2qqbar(s, t, u), f, -f);
+					add(gg2qqbar(s, u, t), -f, f);
+				}
+				break;
+			case QG:
+				// whichever comes in as the quark, t is between the quarks
+				add(qg2qg(s, t, u), pid1, pid2);
+				add(qg2qg(s, u, t), pid2, pid1);
+				break;
+			case NUM_CHANNELS:
+				break;
 		}
-		total += total_qqbar2gg;
 
-		// g + g -> q + qb
-		double total_gg2qqbar = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[i], x2, S)
-				* (1.0/M_PI)*gg2qqbar(eta3, _eta4, Et, alphaS);
+		double total = 0.0;
+		for (uint i=0; i<n; i++)
+			total += candidates[i].weight;
+		double r = rng.uniform()*total;
+		uint pick = 0;
+		while (pick+1 < n && r >= candidates[pick].weight) {
+			r -= candidates[pick].weight;
+			pick++;
 		}
-		total += total_gg2qqbar;
+		return {candidates[pick].pid3, candidates[pick].pid4};
+	}
+
+	void PP2Jets::generate_particles(std::span<const double, num_dims> phaseSpacePoints, std::vector<Particle>& particles, Random& rng) {
+		double Et = phaseSpacePoints[0];
+		double eta3 = phaseSpacePoints[1];
 
-		// q + g -> q + g
-		double total_qg2qg = 0.0;
-		for (uint i=0; i<pids.size(); i++) {
-			total_qqprime2qqprime += pdf.xfxQ2(pids[i], x1, S)*pdf.xfxQ2(pids[i], x2, S)
-				* (1.0/M_PI)*qg2qg(eta3, _eta4, Et, alphaS);
+		double x1 = calc_x1(eta3, _eta4, Et);
+		double x2 = calc_x2(eta3, _eta4, Et);
+		double eta_star = calc_eta_star(eta3, _eta4);
+		double s = calc_sh(eta_star, Et);
+		double t = calc_th(eta_star, Et);
+		double u = -s - t;
+
+		// the incoming flavours, by their share of the cross section;
+		// alpha_s is the same for all of them
+		double Q2 = Et*Et;
+		PDFSet const& pdf = *_pdf;
+		pdf.xfxQ2(x1, Q2, _xf1);
+		pdf.xfxQ2(x2, Q2, _xf2);
+		_pdf_calls += 2;
+		std::array<double, NUM_CHANNELS> xs = channel_cross_sections(s, t, u, 1.0);
+		double total = 0.0;
+		for (uint i=0; i<NUM_FLAVOURS; i++)
+			for (uint j=0; j<NUM_FLAVOURS; j++)
+				total += _xf1[i+1] * _xf2[j+1] * xs[_channel_map[i][j]];
+
+		double r = rng.uniform()*total;
+		uint pick = 0;
+		for (; pick+1<NUM_FLAVOURS*NUM_FLAVOURS; pick++) {
+			uint i = pick/NUM_FLAVOURS, j = pick%NUM_FLAVOURS;
+			double w = _xf1[i+1] * _xf2[j+1] * xs[_channel_map[i][j]];
+			if (r < w)
+				break;
+			r -= w;
 		}
-		total += 2*total_qg2qg;
+		int pid1 = static_cast<int>(pick/NUM_FLAVOURS) - static_cast<int>(NF);
+		int pid2 = static_cast<int>(pick%NUM_FLAVOURS) - static_cast<int>(NF);
+		auto [pid3, pid4] = outgoing_flavours(pid1, pid2, s, t, u, rng);
+		auto pdg = [](int pid) { return pid == 0 ? 21 : pid; };
 
-		total *= 2.0*Et;
-		return Result(total);
-	}
+		// the jets are back to back in the transverse plane
+		double phi = rng.uniform()*2.0*M_PI;
+		double px = Et*std::cos(phi);
+		double py = Et*std::sin(phi);
 
-	void PP2Jets::generate_particles(std::vector<Particle>& momenta) {
-		// does nothing yet
-		(void)momenta;
-		return;
+		particles.emplace_back(
+			FourVector{0.5*x1*_ecm, 0.0, 0.0, 0.5*x1*_ecm},
+			pdg(pid1), "p1", ParticleStatus::INCOMING);
+		particles.emplace_back(
+			FourVector{0.5*x2*_ecm, 0.0, 0.0, -0.5*x2*_ecm},
+			pdg(pid2), "p2", ParticleStatus::INCOMING);
+		particles.emplace_back(
+			FourVector{Et*std::cosh(eta3), px, py, Et*std::sinh(eta3)},
+			pdg(pid3), "j1");
+		particles.emplace_back(
+			FourVector{Et*std::cosh(_eta4), -px, -py, Et*std::sinh(_eta4)},
+			pdg(pid4), "j2");
 	}
 
 }; // namespace ColSim
@@ -0,0 +1,57 @@
+#include "colsim/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	Histogram::Histogram(std::string const& name, double low, double high, uint bins)
+		: _name{name}, _low{low}, _high{high}, _sum_w(bins + 2, 0.0), _sum_w2(bins + 2, 0.0)
+	{
+		if (bins == 0 || !(high > low))
+			COLSIM_LOG(LOG_ERROR, "Histogram::Histogram()", "Histogram '{}' needs at least one bin and high > low.", name);
+	}
+
+	void Histogram::fill(double x, double weight) {
+		uint i;
+		if (x < _low)
+			i = 0;
+		else if (x >= _high)
+			i = _sum_w.size() - 1;
+		else
+			i = 1 + std::min(static_cast<uint>((x - _low)/width()), bins() - 1);
+		_sum_w[i] += weight;
+		_sum_w2[i] += weight*weight;
+	}
+
+	void Histogram::merge(Histogram const& other) {
+		if (other._name != _name || other._low != _low || other._high != _high || other.bins() != bins())
+			COLSIM_LOG(LOG_ERROR, "Histogram::merge()", "Cannot merge histogram '{}' into '{}' with different binning.", other._name, _name);
+		for (uint i=0; i<_sum_w.size(); i++) {
+			_sum_w[i] += other._sum_w[i];
+			_sum_w2[i] += other._sum_w2[i];
+		}
+	}
+
+	void Histogram::save(CheckpointWriter& out) const {
+		out.write(_name);
+		out.write(_low);
+		out.write(_high);
+		out.write(_sum_w);
+		out.write(_sum_w2);
+	}
+
+	Histogram Histogram::load(CheckpointReader& in) {
+		std::string name = in.read_string();
+		double low = in.read<double>();
+		double high = in.read<double>();
+		Histogram h(name, low, high, 1);
+		in.read(h._sum_w);
+		in.read(h._sum_w2);
+		if (h._sum_w.size() < 3 || h._sum_w2.size() != h._sum_w.size())
+			COLSIM_LOG(LOG_ERROR, "Histogram::load()", "Histogram '{}' is corrupt.", name);
+		return h;
+	}
+}; // namespace colsim
@@ -0,0 +1,172 @@
+#include "colsim/logger.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace colsim
+{
+	namespace
+	{
+		// set once the calling thread's ring was handed back; plain data,
+		// so it can still be read while the thread is being torn down
+		thread_local bool ring_gone = false;
+	}
+
+
+	Logger::Logger() {
+		_thread = std::thread([this]() {
+			std::unique_lock lock(_wake_mutex);
+			while (!_stopping) {
+				_wake.wait_for(lock, DRAIN_INTERVAL, [this]() { return _stopping; });
+				lock.unlock();
+				flush();
+				lock.lock();
+			}
+		});
+	}
+
+
+	Logger& Logger::instance() {
+		static Logger* logger = []() {
+			// never deleted, so that messages from the destructors of other
+			// statics still have somewhere to go after stop()
+			Logger* logger = new Logger();
+			std::atexit([]() { instance().stop(); });
+			return logger;
+		}();
+		return *logger;
+	}
+
+
+	void Logger::open(std::string const& path) {
+		bool failed = false;
+		{
+			std::lock_guard lock(_drain_mutex);
+			drain();
+			if (path == _file_path)
+				return;
+			_file.close();
+			_file_path = path;
+			if (!path.empty()) {
+				_file.open(path, std::ios::trunc);
+				failed = !_file;
+			}
+		}
+		if (failed)
+			write(LOG_WARNING, "Logger::open()", 0, "Could not open log file '{}', logging to stdout only", path);
+	}
+
+
+	void Logger::flush() {
+		std::lock_guard lock(_drain_mutex);
+		drain();
+	}
+
+
+	Logger::Ring* Logger::ring() {
+		if (ring_gone)
+			return nullptr;
+
+		thread_local RingHandle handle{};
+		if (!handle.ring) {
+			handle.ring = std::make_shared<Ring>();
+			std::lock_guard lock(_rings_mutex);
+			_rings.push_back(handle.ring);
+		}
+		return handle.ring.get();
+	}
+
+
+	Logger::RingHandle::~RingHandle() {
+		ring_gone = true;
+		if (ring)
+			ring->retired.store(true, std::memory_order_release);
+	}
+
+
+	Logger::Ring* Logger::ring_for(int log_type) {
+		Ring* r = log_type >= LOG_ERROR || _stopped.load(std::memory_order_acquire) ? nullptr : ring();
+		if (!r)
+			return nullptr;
+
+		uint64_t head = r->head.load(std::memory_order_relaxed);
+		while (head - r->tail.load(std::memory_order_acquire) == RING_SIZE)
+			flush();
+		return r;
+	}
+
+
+	void Logger::publish(Ring& r) {
+		uint64_t head = r.head.load(std::memory_order_relaxed);
+		r.slots[head % RING_SIZE].sequence = _sequence.fetch_add(1, std::memory_order_relaxed);
+		r.head.store(head + 1, std::memory_order_release);
+	}
+
+
+	void Logger::write_direct(Slot const& slot) {
+		std::lock_guard lock(_drain_mutex);
+		drain();
+		write_out(std::string_view(slot.text.data(), slot.length));
+		std::cout.flush();
+		if (_file.is_open())
+			_file.flush();
+	}
+
+
+	void Logger::drain() {
+		std::vector<std::shared_ptr<Ring>> rings;
+		{
+			// rings of threads that are gone are dropped once empty; their
+			// thread is done writing once it set the flag, so its head is final
+			std::lock_guard lock(_rings_mutex);
+			std::erase_if(_rings, [](std::shared_ptr<Ring> const& r) {
+				return r->retired.load(std::memory_order_acquire)
+					&& r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed);
+			});
+			rings = _rings;
+		}
+
+		std::vector<uint64_t> heads(rings.size());
+		_pending.clear();
+		for (uint i=0; i<rings.size(); i++) {
+			uint64_t tail = rings[i]->tail.load(std::memory_order_relaxed);
+			heads[i] = rings[i]->head.load(std::memory_order_acquire);
+			for (uint64_t k=tail; k<heads[i]; k++)
+				_pending.push_back(&rings[i]->slots[k % RING_SIZE]);
+		}
+		if (_pending.empty())
+			return;
+
+		std::ranges::sort(_pending, {}, &Slot::sequence);
+		for (Slot const* slot : _pending)
+			write_out(std::string_view(slot->text.data(), slot->length));
+		std::cout.flush();
+		if (_file.is_open())
+			_file.flush();
+
+		// only now may the threads reuse the slots
+		for (uint i=0; i<rings.size(); i++)
+			rings[i]->tail.store(heads[i], std::memory_order_release);
+	}
+
+
+	void Logger::write_out(std::string_view text) {
+		std::cout << text;
+		if (_file.is_open())
+			_file << text;
+	}
+
+
+	void Logger::stop() {
+		_stopped.store(true, std::memory_order_release);
+		{
+			std::lock_guard lock(_wake_mutex);
+			_stopping = true;
+		}
+		_wake.notify_one();
+		if (_thread.joinable())
+			_thread.join();
+		flush();
+	}
+}; // namespace colsim
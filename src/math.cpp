@@ -5,22 +5,22 @@
 
 namespace colsim
 {
+	// the distributions are made on each call; a static one
+	// would keep the bounds it was first called with
 	int rand_int(uint low, uint high)
 	{
-		static std::uniform_int_distribution<> dist(low, high);
-		return dist(random_utils.mt);
+		std::uniform_int_distribution<> dist(low, high);
+		return dist(random_utils.rng);
 	}
 
 	double rand_double(double low, double high)
 	{
-		static std::uniform_real_distribution<double> dist(low, high);
-		return dist(random_utils.mt);
+		return low + (high - low)*random_utils.rng.uniform();
 	}
 
 	double rand_double()
 	{
-		static std::uniform_real_distribution<double> dist(0.0, 1.0);
-		return dist(random_utils.mt);
+		return random_utils.rng.uniform();
 	}
 
 }; // namespace ColSim
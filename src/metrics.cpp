@@ -0,0 +1,116 @@
+#include "colsim/metrics.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	namespace
+	{
+		/** Counters of the threads still running, and the sums
+		 *  of those of the threads that have finished.
+		 */
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<metrics_detail::ThreadMetrics*> threads{};
+			Metrics finished{};
+		};
+
+		// never deleted, so that threads finishing during exit still find it
+		Registry& registry() {
+			static Registry* r = new Registry();
+			return *r;
+		}
+
+		void add_to(Metrics& sum, metrics_detail::ThreadMetrics const& m) {
+			for (uint i=0; i<NUM_COUNTERS; i++)
+				sum.counters[i] += m.counters[i].load(std::memory_order_relaxed);
+			for (uint i=0; i<NUM_TIMERS; i++) {
+				sum.nanoseconds[i] += m.nanoseconds[i].load(std::memory_order_relaxed);
+				sum.calls[i] += m.calls[i].load(std::memory_order_relaxed);
+			}
+		}
+
+		// where threads count once their own counters are handed back
+		metrics_detail::ThreadMetrics discarded{};
+
+		/** The counters of a thread, handed back when it exits.
+		 */
+		struct ThreadHandle
+		{
+			std::unique_ptr<metrics_detail::ThreadMetrics> metrics{std::make_unique<metrics_detail::ThreadMetrics>()};
+
+			ThreadHandle() {
+				Registry& r = registry();
+				std::lock_guard lock(r.mutex);
+				r.threads.push_back(metrics.get());
+			}
+
+			~ThreadHandle() {
+				Registry& r = registry();
+				std::lock_guard lock(r.mutex);
+				add_to(r.finished, *metrics);
+				std::erase(r.threads, metrics.get());
+				metrics_detail::current = &discarded;
+			}
+		};
+	}
+
+
+	metrics_detail::ThreadMetrics* metrics_detail::register_thread() {
+		thread_local ThreadHandle handle{};
+		current = handle.metrics.get();
+		return current;
+	}
+
+
+	Metrics Metrics::operator-(Metrics const& earlier) const {
+		Metrics res = *this;
+		for (uint i=0; i<NUM_COUNTERS; i++)
+			res.counters[i] -= earlier.counters[i];
+		for (uint i=0; i<NUM_TIMERS; i++) {
+			res.nanoseconds[i] -= earlier.nanoseconds[i];
+			res.calls[i] -= earlier.calls[i];
+		}
+		return res;
+	}
+
+
+	Metrics Metrics::collect() {
+		Registry& r = registry();
+		std::lock_guard lock(r.mutex);
+		Metrics res = r.finished;
+		for (metrics_detail::ThreadMetrics const* m : r.threads)
+			add_to(res, *m);
+		return res;
+	}
+
+
+	std::string Metrics::to_json() const {
+		std::string json = std::format("{{\n  \"enabled\": {},\n  \"counters\": {{\n", COLSIM_METRICS ? "true" : "false");
+		for (uint i=0; i<NUM_COUNTERS; i++)
+			json += std::format("    \"{}\": {}{}\n", counter_names[i], counters[i], i+1 < NUM_COUNTERS ? "," : "");
+		json += "  },\n  \"timers\": {\n";
+		for (uint i=0; i<NUM_TIMERS; i++)
+			json += std::format("    \"{}\": {{\"seconds\": {:.6f}, \"calls\": {}}}{}\n",
+								timer_names[i], 1e-9*static_cast<double>(nanoseconds[i]), calls[i], i+1 < NUM_TIMERS ? "," : "");
+		json += "  }\n}\n";
+		return json;
+	}
+
+
+	void Metrics::write_json(std::string const& path) const {
+		std::ofstream out(path, std::ios::trunc);
+		out << to_json();
+		out.close();
+		if (!out)
+			COLSIM_LOG(LOG_WARNING, "Metrics::write_json()", "Could not write metrics to '{}'", path);
+	}
+}; // namespace colsim
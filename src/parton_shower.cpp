@@ -1,250 +1,477 @@
 #include "colsim/parton_shower.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <limits>
+#include <thread>
 
 #include "colsim/alphas.hpp"
 #include "colsim/math.hpp"
+#include "colsim/metrics.hpp"
+#include "colsim/roots.hpp"
+#include "colsim/trace.hpp"
 #include "colsim/utils.hpp"
 
 namespace colsim
 {
 
-	
-	double PartonShower::tgamma(double z, double alphas_over)
+	VetoStats::Counts VetoStats::total() const
 	{
-		return -2.0*alphas_over*CF*std::log1p(-z);
+		Counts sum{};
+		for (Counts const& c : bins) {
+			sum.trials += c.trials;
+			sum.splitting_vetoes += c.splitting_vetoes;
+			sum.alphas_vetoes += c.alphas_vetoes;
+			sum.accepted += c.accepted;
+		}
+		return sum;
 	}
 
-	double PartonShower::tgamma_inv(double r, double alphas_over)
+	void VetoStats::merge(VetoStats const& other)
 	{
-		return 1.0 - std::exp(-0.5*r / (CF*alphas_over));
+		for (uint i=0; i<bins.size(); i++) {
+			bins[i].trials += other.bins[i].trials;
+			bins[i].splitting_vetoes += other.bins[i].splitting_vetoes;
+			bins[i].alphas_vetoes += other.bins[i].alphas_vetoes;
+			bins[i].accepted += other.bins[i].accepted;
+		}
 	}
 
-	double PartonShower::zp_over(double t)
-	{
-		double Qcut = SETTINGS.evol_energy_cutoff;
-		return 1.0-std::sqrt(Qcut*Qcut/t);
-	}
 
-	double PartonShower::zm_over(double t)
+	PartonShower::Overestimate PartonShower::step_overestimate(PartonKind kind, double Q, double Qcut) const
 	{
-		double Qcut = SETTINGS.evol_energy_cutoff;
-		return std::sqrt(Qcut*Qcut/t);
+		double eps = Qcut/Q;
+		double edge = eps*(1.0-eps);
+		if (kind == PartonKind::QUARK) {
+			// Pqq/Pqq_over = (1+z^2)/2, largest at z = 1-eps
+			double zmax = 1.0-eps;
+			return Overestimate{QUARK_OVERESTIMATE.c_log*0.5*(1.0 + zmax*zmax), 0.0};
+		}
+
+		// Pgg/Pgg_over = (1 - z(1-z))^2 and z^2 + (1-z)^2 = 1 - 2z(1-z),
+		// both largest at the edges of the z-range
+		uint nf = 3 + (Q*Q >= C_MASS_2) + (Q*Q >= B_MASS_2);
+		return Overestimate{
+			GLUON_OVERESTIMATE.c_log*(1.0-edge)*(1.0-edge),
+			TR*nf*(1.0 - 2.0*edge)
+		};
 	}
 
-	double PartonShower::Pqq(double z)
+	
+	double PartonShower::Pqq(double z) const
 	{
 		return CF*(1.0 + z*z) / (1.0-z);
 	}
 	
-	double PartonShower::Pqq_over(double z)
+	double PartonShower::Pqq_over(double z, Overestimate const& over) const
 	{
-		return 2.0*CF / (1.0-z);
+		return over.c_log / (1.0-z);
 	}
 
+	double PartonShower::Pgg(double z) const
+	{
+		return CA*(z/(1.0-z) + (1.0-z)/z + z*(1.0-z));
+	}
 
-	double PartonShower::emission_scale_func(double log_T_Q2, void* _params)
+	double PartonShower::Pgg_over(double z, Overestimate const& over) const
 	{
-		Params* params = reinterpret_cast<Params*>(_params);
-		double Q = params->Q;
-		double r = params->r;
-		double alphas_over = params->alphas_over;
+		// c_log is shared between the two soft ends
+		return 0.5*over.c_log*(1.0/(1.0-z) + 1.0/z);
+	}
 
-		double t = Q*Q * std::exp(log_T_Q2);
-		double rho = tgamma(zp_over(t), alphas_over) - tgamma(zm_over(t), alphas_over);
+	double PartonShower::Pgq(double z, uint nf) const
+	{
+		return TR*nf*(z*z + (1.0-z)*(1.0-z));
+	}
 
-		return log_T_Q2 - (1.0/rho)*std::log(r);
+	double PartonShower::Pgq_over(double, Overestimate const& over) const
+	{
+		return over.c_flat;
 	}
 
-    double PartonShower::get_t_emission(double Q, double Qcut, double r, double tfac, double alphas_over)
+
+	std::pair<double, double> PartonShower::emission_scale_func(double l, double lQ, double log_r, double alphas_over,
+																Overestimate const& over) const
 	{
-		auto emissionFunc = [&](double x, void* y) -> double {
-			return emission_scale_func(x, y);
-		};
-		Params params{Q, Qcut, r, alphas_over};
+		double eps = std::exp(-0.5*l);
+		double rho = alphas_over*(over.c_log*std::log((1.0-eps)/eps) + over.c_flat*(1.0-2.0*eps));
 
-	    double min = std::log(tfac * Qcut*Qcut / (Q*Q));
-		double max = 0.0f;
-		double tolerance = 1e-3F;
+		// d(rho)/dl = a (c_log / (2(1 - eps)) + c_flat eps)
+		double rho_prime = alphas_over*(0.5*over.c_log/(1.0-eps) + over.c_flat*eps);
+		return {(l - lQ)*rho - log_r, rho + (l - lQ)*rho_prime};
+	}
 
-	    double root = Bisection(emissionFunc, min, max, 1000, tolerance, reinterpret_cast<void*>(&params));
+	bool PartonShower::emission_scale_equation(double Q, double Qcut, double r, double tfac, double alphas_over,
+											   Overestimate const& over, EmissionScaleEquation& eq) const
+	{
+		// In terms of l = log(t/Qcut^2) the emission scale solves
+		//   H(l) = (l - lQ) rho(l) - log(r) = 0,
+		// where rho is the z-integral of the summed overestimate.
+		// Since rho <= A l + B with A = a c_log/2 and B = a c_flat, replacing
+		// it makes H a quadratic whose largest root lies at or above the
+		// largest root of H. H is increasing and convex there, so Newton's
+		// method converges to it from above.
+		double A = 0.5*alphas_over*over.c_log;
+		double B = alphas_over*over.c_flat;
+		eq.lQ = std::log(Q*Q / (Qcut*Qcut));
+		eq.l_min = std::log(tfac);
+		eq.log_r = std::log(r);
+
+		// A l^2 + (B - A lQ) l - (B lQ + log r) = 0
+		double b = B - A*eq.lQ;
+		double disc = b*b + 4.0*A*(B*eq.lQ + eq.log_r);
+		if (disc < 0.0)
+			return false;
+		eq.l0 = (std::sqrt(disc) - b) / (2.0*A);
+		return eq.l0 >= eq.l_min;
+	}
 
-		double sol = Q*Q * std::exp(root);
+    double PartonShower::get_t_emission(double Q, double Qcut, double r, double tfac, double alphas_over,
+										Overestimate const& over) const
+	{
+		EmissionScaleEquation eq;
+		if (!emission_scale_equation(Q, Qcut, r, tfac, alphas_over, over, eq))
+			return std::numeric_limits<double>::max();
 
-		// if we get something bad
-		if (std::abs(emission_scale_func(root, reinterpret_cast<void*>(&params))) > tolerance)
+		// any step out of [l_min, l0] means there is no root above the cutoff
+		RootResult res = SafeguardedNewton(
+			[&](double l) { return emission_scale_func(l, eq.lQ, eq.log_r, alphas_over, over); },
+			eq.l0, eq.l_min, eq.l0, NEWTON_TOLERANCE, MAX_NEWTON_ITERATIONS);
+		count(Counter::ROOT_EVALUATIONS, res.evaluations);
+		if (!res.converged())
 			return std::numeric_limits<double>::max();
-		
-		return sol;
+
+		return Qcut*Qcut * std::exp(res.root);
+	}
+
+
+	PartonShower::Branch PartonShower::get_branch(PartonKind kind, double t, double Qcut, Overestimate const& over, double& r) const
+	{
+		if (kind == PartonKind::QUARK)
+			return Q_TO_QG;
+
+		// the two terms of the gluon overestimate at this scale
+		double eps = Qcut/std::sqrt(t);
+		double w_gg = over.c_log*std::log((1.0-eps)/eps);
+		double w_qq = over.c_flat*(1.0-2.0*eps);
+
+		double x = r*(w_gg + w_qq);
+		if (x < w_gg) {
+			r = x/w_gg;
+			return G_TO_GG;
+		}
+		r = (x - w_gg)/w_qq;
+		return G_TO_QQBAR;
+	}
+
+
+	double PartonShower::get_z_emission(Branch branch, double t, double Qcut, double r, double r_flip) const
+	{
+		double eps = Qcut/std::sqrt(t);
+		switch (branch) {
+			case Q_TO_QG:
+				// distributed as 1/(1-z) between eps and 1-eps
+				return 1.0 - (1.0-eps)*std::pow(eps/(1.0-eps), r);
+			case G_TO_GG:
+			{
+				// 1/(1-z) + 1/z is the 1/(1-z) part symmetrised
+				double z = 1.0 - (1.0-eps)*std::pow(eps/(1.0-eps), r);
+				return r_flip < 0.5 ? z : 1.0-z;
+			}
+			case G_TO_QQBAR:
+				return eps + r*(1.0-2.0*eps);
+			default:
+				return 1.0;
+		}
 	}
 
 
+	int PartonShower::emitted_pid(Branch branch, double t, double r) const
+	{
+		if (branch != G_TO_QQBAR)
+			return 21;
+		uint nf = 3 + (t >= C_MASS_2) + (t >= B_MASS_2);
+		int flavour = 1 + std::min(static_cast<uint>(r*nf), nf-1);
+		return -flavour;
+	}
+
 
-	double PartonShower::get_z_emission(double t, double r, double alphas_over)
+	double PartonShower::splitting_ratio(Branch branch, double t, double z, Overestimate const& over) const
 	{
-	    return tgamma_inv( 
-			tgamma(zm_over(t), alphas_over) + r * (tgamma(zp_over(t), alphas_over) - tgamma(zm_over(t), alphas_over)),
-			alphas_over);
+		switch (branch) {
+			case Q_TO_QG:
+				return Pqq(z) / Pqq_over(z, over);
+			case G_TO_GG:
+				return Pgg(z) / Pgg_over(z, over);
+			case G_TO_QQBAR:
+			{
+				// only the flavours lighter than the virtuality can be produced
+				uint nf = 3 + (t >= C_MASS_2) + (t >= B_MASS_2);
+				return Pgq(z, nf) / Pgq_over(z, over);
+			}
+			default:
+				return 0.0;
+		}
 	}
+
 	
-	double PartonShower::get_pt_2(double t, double z)
+	double PartonShower::get_pt_2(double t, double z) const
 	{
 		return z*z * std::pow(1.0-z,2)*t;
 	}
 	
-	double PartonShower::get_m_2(double t, double z)
+	double PartonShower::get_m_2(double t, double z) const
 	{
 		return z*(1.0-z)*t;
 	}
 
-	PartonShower::Emission PartonShower::generate_emission(double Q, double Qcut, double tfac, double alphas_over)
+	void PartonShower::evolve_lanes(std::span<const double> Qs, std::span<const PartonKind> kinds, double Qmin, double alphas_over,
+									uint64_t seed, uint64_t first_stream, EmissionStore& store, std::vector<uint>* order) const
 	{
-		bool generated = true;
-		double r1 = rand_double();
-		double r2 = rand_double();
-		double r3 = rand_double();
-		double r4 = rand_double();
+		using lane_array = std::array<double, NUM_LANES>;
+		ScopedTimer timer(Timer::SHOWER);
 
-		double t = get_t_emission(Q, Qcut, r1, tfac, alphas_over);
-		if (t == std::numeric_limits<double>::max()) 
-			return Emission{t, 1.0, 0.0, 0.0, generated, false};
-		
+		double Qcut = Qmin;
+		double tmin = Qmin*Qmin;
+		double scale_min = std::sqrt(FAC_CUTOFF*tmin);
+		constexpr double NO_EMISSION = std::numeric_limits<double>::max();
+
+		// per lane state: current scale and which parton it holds
+		lane_array scale{};
+		std::array<uint, NUM_LANES> parton{};
+		std::array<bool, NUM_LANES> active{};
+		std::array<PartonKind, NUM_LANES> kind{};
+		std::array<Random, NUM_LANES> rng{};
+		lane_array r1, r2, r3, r4, r5;
+		lane_array t, z, pT_2, m_2, ratio;
+		std::array<Branch, NUM_LANES> branch{};
+		std::array<int, NUM_LANES> emitted{};
+		std::array<Overestimate, NUM_LANES> over{};
+		std::array<bool, NUM_LANES> accepted{};
+		VetoStats stats{};
+
+		// lanes interleave their emissions, so each collects its own
+		// until its shower is complete; the buffers are reused throughout
+		std::array<std::vector<Emission>, NUM_LANES> pending{};
+
+		auto finish = [&](uint index, std::span<const Emission> emissions) {
+			store.add_shower(emissions);
+			if (order)
+				order->push_back(index);
+		};
 
-		double z = get_z_emission(t, r2, alphas_over);
-		double pT_2 = get_pt_2(t, z);
-		double m_2 = get_m_2(t, z);
+		uint next = 0;
+		uint last = Qs.size();
+		uint num_active = 0;
+		auto refill = [&](uint lane) {
+			// partons starting at or below the cutoff have nothing to do
+			while (next < last && Qs[next] <= scale_min)
+				finish(next++, {});
+			active[lane] = next < last;
+			if (!active[lane])
+				return;
+			parton[lane] = next;
+			scale[lane] = Qs[next];
+			kind[lane] = kinds.empty() ? _start_kind : kinds[next];
+			rng[lane] = Random(seed, first_stream + next);
+			pending[lane].clear();
+			next++;
+			num_active++;
+		};
+		for (uint lane=0; lane<NUM_LANES; lane++)
+			refill(lane);
+
+		while (num_active > 0) {
+			// every trial uses five random numbers whether or not it gets that far;
+			// lanes left empty as the batch drains draw none
+			for (uint lane=0; lane<NUM_LANES; lane++) {
+				if (!active[lane])
+					continue;
+				r1[lane] = rng[lane].uniform();
+				r2[lane] = rng[lane].uniform();
+				r3[lane] = rng[lane].uniform();
+				r4[lane] = rng[lane].uniform();
+				r5[lane] = rng[lane].uniform();
+			}
 
-		//LOGGER.logMessage("Candidate emission scale: sqrt(t) = %.9lf", std::sqrt(t));
-		//LOGGER.logMessage("Candidate momentum fraction: z = %.9lf", z);
-		//LOGGER.logMessage("Candidate transverse momentum squared: pt^2 = %.9lf", pT_2);
-		
-		if (pT_2 < 0.0) {
-			generated = false;
-			//LOGGER.logMessage("Emission rejected due to negative pT^2");
-		}
+			// Sudakov: candidate scales from the sum over all branches,
+			// overestimated as tightly as the current scale allows
+			for (uint lane=0; lane<NUM_LANES; lane++) {
+				if (active[lane]) {
+					over[lane] = step_overestimate(kind[lane], scale[lane], Qcut);
+					t[lane] = get_t_emission(scale[lane], Qcut, r1[lane], FAC_T, alphas_over, over[lane]);
+				} else
+					t[lane] = NO_EMISSION;
+			}
 
-		double splittingFnOverRatio = Pqq(z) / Pqq_over(z);
-		if (splittingFnOverRatio < r3) {
-		    //LOGGER.logMessage("Emission rejected due to splitting function overestimate: p = %.9lf R = %.9lf", splittingFnOverRatio, r3);
-			generated = false;
-		} else {
-			//LOGGER.logMessage("Emission NOT rejected due to splitting function overestimate: p = %.9lf R = %.9lf", splittingFnOverRatio, r3);
-		}
+			// which branch emitted, then its momentum fraction and the kinematics
+			for (uint lane=0; lane<NUM_LANES; lane++) {
+				bool found = t[lane] < NO_EMISSION;
+				branch[lane] = found ? get_branch(kind[lane], t[lane], Qcut, over[lane], r5[lane]) : Q_TO_QG;
+				z[lane] = found ? get_z_emission(branch[lane], t[lane], Qcut, r2[lane], r5[lane]) : 1.0;
+				emitted[lane] = found ? emitted_pid(branch[lane], t[lane], r5[lane]) : 21;
+				pT_2[lane] = get_pt_2(t[lane], z[lane]);
+				m_2[lane] = get_m_2(t[lane], z[lane]);
+			}
 
-		double alphas_over_ratio = _alphas.alphas_actual(t,z) / alphas_over;
-		if (alphas_over_ratio < r4) {
-			generated = false;
-			//LOGGER.logMessage("Emission rejected due to alpha_s overestimate: a_s = %.9lf R = %.9lf", alphaSOverRatio, r4);
-		} else {
-			//LOGGER.logMessage("Emission NOT rejected due to alpha_s overestimate: a_s = %.9lf R = %.9lf", alphaSOverRatio, r4);
-		}
+			// vetoes against the overestimates of the splitting function and alpha_s
+			for (uint lane=0; lane<NUM_LANES; lane++) {
+				if (t[lane] == NO_EMISSION) {
+					accepted[lane] = false;
+					continue;
+				}
+				ratio[lane] = splitting_ratio(branch[lane], t[lane], z[lane], over[lane]);
+				double alphas_ratio = _alphas.alphas_actual(t[lane], z[lane]) / alphas_over;
+				accepted[lane] = pT_2[lane] >= 0.0 && ratio[lane] >= r3[lane] && alphas_ratio >= r4[lane];
+			}
 
-		if (!generated) {
-			z = 1.0;
-			pT_2 = 0.0;
-			m_2 = 0.0;
+			// bookkeeping, which is where the lanes part ways
+			for (uint lane=0; lane<NUM_LANES; lane++) {
+				if (!active[lane])
+					continue;
+
+				bool finished = t[lane] == NO_EMISSION || t[lane] < FAC_CUTOFF*tmin;
+				if (!finished) {
+					VetoStats::Counts& counts = stats.bin(t[lane], z[lane]);
+					counts.trials++;
+					if (accepted[lane])
+						counts.accepted++;
+					else if (ratio[lane] < r3[lane])
+						counts.splitting_vetoes++;
+					else
+						counts.alphas_vetoes++;
+
+					double Qt = std::sqrt(t[lane]);
+					if (accepted[lane]) {
+						pending[lane].push_back(Emission{t[lane], z[lane], pT_2[lane], m_2[lane], emitted[lane]});
+						scale[lane] = Qt*z[lane];
+						// the parton followed after g->qqbar is a quark
+						if (branch[lane] == G_TO_QQBAR)
+							kind[lane] = PartonKind::QUARK;
+					} else
+						scale[lane] = Qt;
+					finished = scale[lane] <= scale_min;
+				}
+
+				if (finished) {
+#ifdef DEBUG
+					if (!pending[lane].empty())
+						log_emissions_table(pending[lane]);
+#endif
+					finish(parton[lane], pending[lane]);
+					num_active--;
+					refill(lane);
+				}
+			}
 		}
 
-		return Emission{t, z, pT_2, m_2, generated, true};
+		VetoStats::Counts total = stats.total();
+		count(Counter::SHOWER_TRIALS, total.trials);
+		count(Counter::SHOWER_VETOES, total.splitting_vetoes + total.alphas_vetoes);
+		count(Counter::EMISSIONS, total.accepted);
+
+		std::lock_guard lock(_veto_stats_mutex);
+		_veto_stats.merge(stats);
 	}
 
 
-	// TODO: cleanup this function
-	std::vector<PartonShower::Emission> PartonShower::evolve(double Q, double Qmin, double alphas_over) {
-		double tmin = Qmin*Qmin;
-		uint numEmissions = 0;
+	VetoStats PartonShower::veto_stats() const
+	{
+		std::lock_guard lock(_veto_stats_mutex);
+		return _veto_stats;
+	}
 
-		std::vector<Emission> emissions;
+	void PartonShower::reset_veto_stats()
+	{
+		std::lock_guard lock(_veto_stats_mutex);
+		_veto_stats = VetoStats{};
+	}
 
-		double fac_t = 3.9999;
-		double fac_cutoff = 4.0;
 
-		double t = Q*Q;
-		double z = 1.0;
+	void PartonShower::evolve(double Q, double Qmin, double alphas_over, EmissionStore& store, Random& rng) {
+		evolve_lanes(std::span<const double>(&Q, 1), {}, Qmin, alphas_over, rng(), 0, store);
+	}
 
-		//LOGGER.logMessage("Generating evolution for Q = %.9lf", Q);
 
-		while((std::sqrt(t)*z) > std::sqrt(fac_cutoff * tmin)) {
-			Emission emission = generate_emission(std::sqrt(t)*z, std::sqrt(tmin), fac_t, alphas_over);
-			t = emission.t;
-			z = emission.z;
-			double pT_2 = emission.pT_2;
-			double m_2  = emission.m_2;
-			bool continueEvolution = emission.continue_evol;
+	void PartonShower::evolve_ordered(std::span<const double> Qs, std::span<const PartonKind> kinds, double Qmin, double alphas_over,
+									  uint64_t seed, uint64_t first_stream, EmissionStore& store) const
+	{
+		// the lanes finish their showers out of order,
+		// so they are put back in the order of their partons
+		EmissionStore finished;
+		std::vector<uint> order;
+		order.reserve(Qs.size());
+		evolve_lanes(Qs, kinds, Qmin, alphas_over, seed, first_stream, finished, &order);
+
+		std::vector<uint> location(Qs.size());
+		for (uint i=0; i<order.size(); i++)
+			location[order[i]] = i;
+
+		store.reserve(store.num_showers() + Qs.size(), store.num_emissions() + finished.num_emissions());
+		for (uint i : location)
+			store.add_shower(finished.shower(i));
+	}
 
-			if (!continueEvolution) {
-				// LOGGER.logMessage("No further emissions.");
-				// LOGGER.logMessage("Total emissions: %u", numEmissions);
-#ifdef DEBUG
-				if (numEmissions > 0)
-					logEmissionsTable(emissions);
-#endif				
-				return emissions;
-			}
 
-			if (t < (fac_cutoff*tmin)) {
-				// LOGGER.logMessage("Emission rejected at sqrt(t) = %.9lf since it is below cutoff", std::sqrt(t));
-				// LOGGER.logMessage("Total emissions: %u", numEmissions);
-#ifdef DEBUG
-				if (numEmissions > 0)
-					logEmissionsTable(emissions);
-#endif
-				return emissions;
-			}
+	void PartonShower::evolve_batch(std::span<const double> Qs, double Qmin, double alphas_over,
+									EmissionStore& store, Random& rng,
+									std::span<const PartonKind> kinds) const
+	{
+		evolve_ordered(Qs, kinds, Qmin, alphas_over, rng(), 0, store);
+	}
 
-			if (z < 0.0) {
-				// LOGGER.logMessage("Emission rejected at sqrt(t) = %.9lf since z<0: z=%.9lf", std::sqrt(t), z);
-			    // LOGGER.logMessage("Total emissions: %u", numEmissions);
-#ifdef DEBUG
-				if (numEmissions > 0)
-					logEmissionsTable(emissions);
-#endif
-				return emissions;
-			}
 
-			if (z != 1.0) {
-				emissions.emplace_back(std::sqrt(t), z, std::sqrt(pT_2), std::sqrt(m_2), true, true);
-				numEmissions++;
+	void PartonShower::evolve_batch(std::span<const double> Qs, double Qmin, double alphas_over,
+									EmissionStore& store, uint num_threads, Random& rng) const
+	{
+		uint num_partons = Qs.size();
+		if (num_partons == 0)
+			return;
+
+		// no point in threads with less than a full set of lanes each
+		num_threads = std::clamp(num_threads, 1u, std::max(1u, num_partons/NUM_LANES));
+		std::vector<EmissionStore> stores(num_threads);
+
+		// parton i uses stream i whichever thread evolves it
+		uint64_t seed = rng();
+		auto work = [&](uint thread) {
+			uint first = static_cast<uint64_t>(num_partons)*thread/num_threads;
+			uint last = static_cast<uint64_t>(num_partons)*(thread+1)/num_threads;
+			if (thread > 0)
+				Tracer::instance().name_thread("shower thread");
+			TraceScope trace("evolve", "shower", "partons", last - first);
+			evolve_ordered(Qs.subspan(first, last - first), {}, Qmin, alphas_over, seed, first, stores[thread]);
+		};
 
-				// LOGGER.logMessage("Successful emission at sqrt(t) = %.9lf", std::sqrt(t));
-				// LOGGER.logMessage("  z = %.9lf", z);
-				// LOGGER.logMessage("  pT = %.9lf", std::sqrt(pT_2));
-				// LOGGER.logMessage("  m = %.9lf",  std::sqrt(m_2));
-			}
+		{
+			std::vector<std::jthread> threads;
+			threads.reserve(num_threads-1);
+			for (uint thread=1; thread<num_threads; thread++)
+				threads.emplace_back(work, thread);
+			work(0);
 		}
 
-		// LOGGER.logMessage("No futher emissions");
-		// LOGGER.logMessage("Total emission: %u", numEmissions);
-
-		// simply list all of the emissions in a nice format
-#ifdef DEBUG
-		if (numEmissions > 0)
-			logEmissionsTable(emissions);
-#else
-		(void)numEmissions;
-#endif
-
-		// LOGGER.logMessage("Evolution completed! Performed %d emissions.", emissions.size());
-		return emissions;
+		for (EmissionStore const& s : stores)
+			store.append(s);
 	}
 
 
 
 
-	void PartonShower::log_emissions_table(std::vector<Emission> const& emissions) {
-		log(LOG_INFO, "PartonShower::log_emissions_table()", "Emissions table:");
-		log(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
-		log(LOG_INFO, "PartonShower::log_emissions_table()", "| # |  Evo scale [GeV]   |         1-z         |      pT [GeV]      | virt. mass in a->bc [GeV] |");
-		log(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
+	void PartonShower::log_emissions_table(std::span<const Emission> emissions) const {
+		COLSIM_LOG(LOG_INFO, "PartonShower::log_emissions_table()", "Emissions table:");
+		COLSIM_LOG(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
+		COLSIM_LOG(LOG_INFO, "PartonShower::log_emissions_table()", "| # |  Evo scale [GeV]   |         1-z         |      pT [GeV]      | virt. mass in a->bc [GeV] |");
+		COLSIM_LOG(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
 
 		uint count = 0;
 		for (Emission const& e : emissions) {
-			log(LOG_INFO,
+			COLSIM_LOG(LOG_INFO,
 				"PartonShower::log_emissions_table()", "| {} |      {:8.3f}      | {:19.15f} | {:18.15f} |     {:17.14f}     |",
-				count++, e.t, 1.0-e.z, std::sqrt(e.pT_2), std::sqrt(e.m_2));
+				count++, std::sqrt(e.t), 1.0-e.z, std::sqrt(e.pT_2), std::sqrt(e.m_2));
 		}
 		
-		log(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
+		COLSIM_LOG(LOG_INFO, "PartonShower::log_emissions_table()", "+---+--------------------+---------------------+--------------------+---------------------------+");
 	}
 }; // namespace ColSim
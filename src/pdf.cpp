@@ -0,0 +1,288 @@
+#include "colsim/pdf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "colsim/metrics.hpp"
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	namespace
+	{
+		/** Start of a cached grid, followed by alpha_s at every Q2
+		 *  node and then xf of every parton at every (Q2, x) node.
+		 */
+		struct GridHeader
+		{
+			static constexpr uint64_t MAGIC = 0x4449524746445043; // "CPDFGRID"
+			static constexpr uint32_t VERSION = 1;
+
+			uint64_t magic;
+			uint32_t version;
+			int32_t member;
+			uint32_t num_x, num_q2, num_partons, unused;
+			double u_min, u_max, v_min, v_max;
+			char name[64];
+		};
+
+		constexpr size_t GRID_SIZE = sizeof(GridHeader)
+			+ sizeof(double)*PDFSet::NUM_Q2*(1 + PDFSet::NUM_X*PDFSet::NUM_PARTONS);
+
+		// the grid ends just short of x=1, where log(x/(1-x)) diverges
+		constexpr double MAX_X = 1.0 - 1e-7;
+
+		/** Weights of the nodes at -1, 0, 1 and 2 for the cubic
+		 *  through them, at @a t from the second.
+		 */
+		inline std::array<double, 4> cubic_weights(double t) {
+			double tp = t + 1.0, tm = t - 1.0, tmm = t - 2.0;
+			return {
+				-t*tm*tmm/6.0,
+				tp*tm*tmm/2.0,
+				-tp*t*tmm/2.0,
+				tp*t*tm/6.0
+			};
+		}
+
+		/** First of the four nodes around @a s, in units of
+		 *  the spacing from the first of @a n nodes.
+		 */
+		inline uint first_node(double s, uint n, double& t) {
+			int i = std::clamp(static_cast<int>(std::floor(s)) - 1, 0, static_cast<int>(n) - 4);
+			t = s - (i + 1);
+			return i;
+		}
+	}
+
+
+	PDFSet::PDFSet(std::string const& name, int member, std::string const& cache_path)
+		: _name{name}, _member{member}, _cache_path{cache_path}
+	{}
+
+	PDFSet::~PDFSet() {
+		if (_map)
+			munmap(_map, _map_size);
+	}
+
+
+	std::shared_ptr<const PDFSet> PDFSet::get(std::string const& name, int member, std::string const& cache_dir) {
+		static std::mutex mutex;
+		static std::map<std::tuple<std::string, int, std::string>, std::shared_ptr<const PDFSet>> sets;
+
+		std::lock_guard lock(mutex);
+		auto key = std::make_tuple(name, member, cache_dir);
+		auto it = sets.find(key);
+		if (it != sets.end())
+			return it->second;
+
+		std::string cache_path{};
+		if (!cache_dir.empty())
+			cache_path = (std::filesystem::path(cache_dir) / std::format("{}_{}.grid", name, member)).string();
+		std::shared_ptr<const PDFSet> set(new PDFSet(name, member, cache_path));
+		sets.emplace(key, set);
+		return set;
+	}
+
+
+	void PDFSet::load() const {
+		std::call_once(_loaded, [this]() {
+			ScopedTimer timer(Timer::PDF_LOAD);
+			if (_cache_path.empty()) {
+				COLSIM_LOG(LOG_INFO, "PDFSet::load()", "Loading PDF set '{}', member {}", _name, _member);
+				LHAPDF::setVerbosity(0);
+				_lhapdf.reset(LHAPDF::mkPDF(_name, _member));
+				return;
+			}
+
+			if (map_cache()) {
+				COLSIM_LOG(LOG_INFO, "PDFSet::load()", "Using the cached grid '{}' of PDF set '{}'", _cache_path, _name);
+				return;
+			}
+			write_cache();
+			if (!map_cache())
+				COLSIM_LOG(LOG_ERROR, "PDFSet::load()", "Could not read back the cached grid '{}'", _cache_path);
+		});
+	}
+
+
+	void PDFSet::write_cache() const {
+		COLSIM_LOG(LOG_INFO, "PDFSet::write_cache()", "Tabulating PDF set '{}', member {}, into '{}'", _name, _member, _cache_path);
+		LHAPDF::setVerbosity(0);
+		std::unique_ptr<const LHAPDF::PDF> pdf(LHAPDF::mkPDF(_name, _member));
+
+		GridHeader header{};
+		header.magic = GridHeader::MAGIC;
+		header.version = GridHeader::VERSION;
+		header.member = _member;
+		header.num_x = NUM_X;
+		header.num_q2 = NUM_Q2;
+		header.num_partons = NUM_PARTONS;
+		double x_min = pdf->xMin(), x_max = std::min(pdf->xMax(), MAX_X);
+		header.u_min = std::log(x_min/(1.0 - x_min));
+		header.u_max = std::log(x_max/(1.0 - x_max));
+		header.v_min = std::log(pdf->q2Min());
+		header.v_max = std::log(pdf->q2Max());
+		std::strncpy(header.name, _name.c_str(), sizeof(header.name) - 1);
+
+		double du = (header.u_max - header.u_min)/(NUM_X - 1);
+		double dv = (header.v_max - header.v_min)/(NUM_Q2 - 1);
+		std::vector<double> alphas(NUM_Q2);
+		std::vector<double> xf(NUM_Q2*NUM_X*NUM_PARTONS);
+		std::vector<double> xfs;
+		for (uint iq=0; iq<NUM_Q2; iq++) {
+			// the end points exactly, so that rounding never leaves the set's range
+			double q2 = iq == NUM_Q2-1 ? pdf->q2Max() : std::exp(header.v_min + iq*dv);
+			alphas[iq] = pdf->alphasQ2(q2);
+			for (uint ix=0; ix<NUM_X; ix++) {
+				double x = ix == NUM_X-1 ? x_max : 1.0/(1.0 + std::exp(-(header.u_min + ix*du)));
+				pdf->xfxQ2(std::max(x, x_min), q2, xfs);
+				std::copy_n(xfs.begin(), NUM_PARTONS, xf.begin() + (iq*NUM_X + ix)*NUM_PARTONS);
+			}
+		}
+
+		// written under a name of its own and moved into place in one step,
+		// so that runs starting at the same time never see half a grid
+		std::filesystem::path path(_cache_path);
+		std::error_code error;
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path(), error);
+		std::string tmp_path = std::format("{}.{}.tmp", _cache_path, getpid());
+		std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		out.write(reinterpret_cast<char const*>(alphas.data()), sizeof(double)*alphas.size());
+		out.write(reinterpret_cast<char const*>(xf.data()), sizeof(double)*xf.size());
+		out.close();
+		if (!out)
+			COLSIM_LOG(LOG_ERROR, "PDFSet::write_cache()", "Failed writing the cached grid '{}'", tmp_path);
+		std::filesystem::rename(tmp_path, _cache_path, error);
+		if (error)
+			COLSIM_LOG(LOG_ERROR, "PDFSet::write_cache()", "Could not move '{}' to '{}': {}", tmp_path, _cache_path, error.message());
+	}
+
+
+	bool PDFSet::map_cache() const {
+		int fd = open(_cache_path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != GRID_SIZE) {
+			close(fd);
+			return false;
+		}
+		void* map = mmap(nullptr, GRID_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED)
+			return false;
+
+		GridHeader const& header = *static_cast<GridHeader const*>(map);
+		bool valid = header.magic == GridHeader::MAGIC && header.version == GridHeader::VERSION
+			&& header.member == _member && header.num_x == NUM_X && header.num_q2 == NUM_Q2
+			&& header.num_partons == NUM_PARTONS
+			&& std::string(header.name, strnlen(header.name, sizeof(header.name))) == _name;
+		if (!valid) {
+			COLSIM_LOG(LOG_WARNING, "PDFSet::map_cache()", "'{}' is not a cached grid of PDF set '{}', member {}; rewriting it", _cache_path, _name, _member);
+			munmap(map, GRID_SIZE);
+			return false;
+		}
+
+		_map = map;
+		_map_size = GRID_SIZE;
+		_u_min = header.u_min;
+		_du = (header.u_max - header.u_min)/(NUM_X - 1);
+		_v_min = header.v_min;
+		_dv = (header.v_max - header.v_min)/(NUM_Q2 - 1);
+		_alphas = reinterpret_cast<double const*>(static_cast<char const*>(map) + sizeof(GridHeader));
+		_xf = _alphas + NUM_Q2;
+		return true;
+	}
+
+
+	void PDFSet::locate(double x, double q2, uint& ix, uint& iq,
+						std::array<double, 4>& wx, std::array<double, 4>& wq) const
+	{
+		// outside the grid, the densities are those at its edge
+		double u = std::log(x/(1.0 - x));
+		double v = std::log(q2);
+		double su = std::clamp((u - _u_min)/_du, 0.0, static_cast<double>(NUM_X - 1));
+		double sv = std::clamp((v - _v_min)/_dv, 0.0, static_cast<double>(NUM_Q2 - 1));
+		double tx, tq;
+		ix = first_node(su, NUM_X, tx);
+		iq = first_node(sv, NUM_Q2, tq);
+		wx = cubic_weights(tx);
+		wq = cubic_weights(tq);
+	}
+
+
+	double PDFSet::xfxQ2(int id, double x, double q2) const {
+		if (_lhapdf)
+			return _lhapdf->xfxQ2(id, x, q2);
+
+		if (id == 21)
+			id = 0;
+		if (id < -6 || id > 6 || x >= 1.0)
+			return 0.0;
+
+		uint ix, iq;
+		std::array<double, 4> wx, wq;
+		locate(x, q2, ix, iq, wx, wq);
+		double const* xf = _xf + (iq*NUM_X + ix)*NUM_PARTONS + (id + 6);
+		double res = 0.0;
+		for (uint j=0; j<4; j++) {
+			double row = 0.0;
+			for (uint i=0; i<4; i++)
+				row += wx[i]*xf[((j*NUM_X) + i)*NUM_PARTONS];
+			res += wq[j]*row;
+		}
+		return res;
+	}
+
+
+	void PDFSet::xfxQ2(double x, double q2, std::vector<double>& xfs) const {
+		if (_lhapdf) {
+			_lhapdf->xfxQ2(x, q2, xfs);
+			return;
+		}
+
+		xfs.assign(NUM_PARTONS, 0.0);
+		if (x >= 1.0)
+			return;
+
+		uint ix, iq;
+		std::array<double, 4> wx, wq;
+		locate(x, q2, ix, iq, wx, wq);
+		for (uint j=0; j<4; j++) {
+			for (uint i=0; i<4; i++) {
+				double w = wq[j]*wx[i];
+				double const* xf = _xf + ((iq + j)*NUM_X + ix + i)*NUM_PARTONS;
+				for (uint p=0; p<NUM_PARTONS; p++)
+					xfs[p] += w*xf[p];
+			}
+		}
+	}
+
+
+	double PDFSet::alphasQ2(double q2) const {
+		if (_lhapdf)
+			return _lhapdf->alphasQ2(q2);
+
+		double sv = std::clamp((std::log(q2) - _v_min)/_dv, 0.0, static_cast<double>(NUM_Q2 - 1));
+		double t;
+		uint iq = first_node(sv, NUM_Q2, t);
+		std::array<double, 4> w = cubic_weights(t);
+		double res = 0.0;
+		for (uint j=0; j<4; j++)
+			res += w[j]*_alphas[iq + j];
+		return res;
+	}
+}; // namespace colsim
@@ -0,0 +1,62 @@
+#include "colsim/random.hpp"
+
+namespace colsim
+{
+	void Random::fill(std::span<double> out)
+	{
+		uint64_t n = out.size();
+		uint64_t i = 0;
+
+		// the second half of a block already started
+		if ((_position & 1) && n > 0)
+			out[i++] = uniform();
+
+		uint32_t s0 = static_cast<uint32_t>(_stream), s1 = static_cast<uint32_t>(_stream >> 32);
+		while (n - i >= 2*FILL_BLOCKS) {
+			// the rounds of philox(), with each step done for all blocks at once
+			std::array<uint32_t, FILL_BLOCKS> c0, c1, c2, c3;
+			uint64_t block = _position >> 1;
+			for (uint b=0; b<FILL_BLOCKS; b++) {
+				c0[b] = static_cast<uint32_t>(block + b);
+				c1[b] = static_cast<uint32_t>((block + b) >> 32);
+				c2[b] = s0;
+				c3[b] = s1;
+			}
+
+			uint32_t k0 = static_cast<uint32_t>(_seed), k1 = static_cast<uint32_t>(_seed >> 32);
+			for (uint round=0; round<10; round++) {
+				for (uint b=0; b<FILL_BLOCKS; b++) {
+					uint64_t p0 = static_cast<uint64_t>(M0) * c0[b];
+					uint64_t p1 = static_cast<uint64_t>(M1) * c2[b];
+					uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[b] ^ k0;
+					uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[b] ^ k1;
+					c1[b] = static_cast<uint32_t>(p1);
+					c3[b] = static_cast<uint32_t>(p0);
+					c0[b] = n0;
+					c2[b] = n2;
+				}
+				k0 += W0;
+				k1 += W1;
+			}
+
+			for (uint b=0; b<FILL_BLOCKS; b++) {
+				out[i + 2*b]     = to_unit((static_cast<uint64_t>(c0[b]) << 32) | c1[b]);
+				out[i + 2*b + 1] = to_unit((static_cast<uint64_t>(c2[b]) << 32) | c3[b]);
+			}
+			i += 2*FILL_BLOCKS;
+			_position += 2*FILL_BLOCKS;
+		}
+
+		for (; i<n; i++)
+			out[i] = uniform();
+	}
+
+
+	void Random::fill(std::span<double> out, double low, double high)
+	{
+		fill(out);
+		double width = high - low;
+		for (double& x : out)
+			x = low + width*x;
+	}
+}; // namespace colsim
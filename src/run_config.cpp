@@ -0,0 +1,277 @@
+#include "colsim/run_config.hpp"
+#include "colsim/utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+
+namespace colsim
+{
+
+	namespace
+	{
+		/** Points @a it at the value of @a key, if there is one.
+		 */
+		bool does_key_exist(RunConfig::value_type const& settings, RunConfig::value_type::const_iterator& it, std::string const& key) {
+			it = settings.find(key);
+			return it != settings.end();
+		}
+	}
+	
+
+	void RunConfig::update_squares() {
+		s = ecm*ecm;
+		min_cutoff_energy_2 = min_cutoff_energy*min_cutoff_energy;
+		trans_energy_2 = trans_energy*trans_energy;
+		initial_evol_e_2 = initial_evol_e*initial_evol_e;
+	}
+
+
+	std::string RunConfig::fingerprint() const {
+		// the number of threads is left out, as results do not depend on it,
+		// and so is where PDF grids are cached, but not whether they are
+		std::string res = std::format("ECM={}\nPDFName={}\nPDFMember={}\nPDFCache={}\n",
+									  ecm/1000.0, pdf_name, pdf_mem, pdf_cache_dir.empty() ? "No" : "Yes");
+		if (!random_seed)
+			res += std::format("Seed={}\n", seed);
+		res += std::format("CheckpointInterval={}\nNumShards={}\nShardIndex={}\n", checkpoint_interval, num_shards, shard_index);
+		res += std::format("Process={}\nNumXSIterations={}\nMinCutoffEnergy={}\nTransformationEnergy={}\nStoreMEComponents={}\n",
+						   process, num_iterations, min_cutoff_energy, trans_energy, store_me_components ? "Yes" : "No");
+		res += std::format("InitialEvolEnergy={}\nFixedScale={}\nEvolutionEnergyCutoff={}\n",
+						   initial_evol_e, fixed_scale ? "Yes" : "No", evol_energy_cutoff);
+		return res;
+	}
+
+
+	RunConfig RunConfig::load(std::string const& config_file_path) {
+		RunConfig config{};
+		value_type settings;
+		if (config_file_path.length() > 0) {
+			std::ifstream config_file_stream;
+			config_file_stream.open(config_file_path);
+			if (!config_file_stream) 
+				COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "Could not open config file '{}'", config_file_path);
+				
+			std::string line;
+			std::vector<std::string> tokens;
+			while (std::getline(config_file_stream, line)) {
+				// skip empty lines and comments
+				if ((line.size() <= 1) || (line[0] == '#'))
+					continue;
+				
+				tokens = 
+					line
+					| std::ranges::views::split('=')
+					| std::ranges::to<std::vector<std::string>>();
+
+				settings.insert({tokens[0], tokens[1]});
+			
+				tokens.clear();
+			}
+			config_file_stream.close();
+		}
+
+	    value_type::const_iterator it;
+
+		// center of mass energy
+		// in TeV; must scale to GeV
+		if (does_key_exist(settings, it, "ECM")) {
+			config.ecm = std::stod(it->second);
+			if (config.ecm < 5.0 || config.ecm > 20.0)
+				COLSIM_LOG(LOG_WARNING, "RunConfig::load()", "ECM value of {} is abnormal.", config.ecm);
+			config.ecm *= 1000.0;
+			config.s = config.ecm*config.ecm;
+		} else {
+			config.ecm = 14000.0;
+			config.s = config.ecm*config.ecm;
+		}
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using ECM={}", config.ecm);
+
+		// name of PDF
+		if(does_key_exist(settings, it, "PDFName"))
+			config.pdf_name = it->second;
+		else
+			config.pdf_name = "CT18NNLO";
+		if(does_key_exist(settings, it, "PDFCacheDir"))
+			config.pdf_cache_dir = it->second;
+		else
+			config.pdf_cache_dir = "";
+		config.pdf = PDFSet::get(config.pdf_name, config.pdf_mem, config.pdf_cache_dir);
+
+		// seed of the random number streams, so that a run can be repeated
+		if(does_key_exist(settings, it, "Seed"))
+			config.seed = std::stoull(it->second);
+		else
+			config.seed = 0;
+		config.random_seed = config.seed == 0;
+		if (config.random_seed) {
+			std::random_device dev;
+			config.seed = (static_cast<uint64_t>(dev()) << 32) | dev();
+		}
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using random seed {}", config.seed);
+
+		// periodic checkpoints, from which an interrupted run continues
+		if(does_key_exist(settings, it, "CheckpointFile"))
+			config.checkpoint_file = it->second;
+		else
+			config.checkpoint_file = "";
+		if(does_key_exist(settings, it, "CheckpointInterval"))
+			config.checkpoint_interval = std::stoul(it->second);
+		else
+			config.checkpoint_interval = 100000;
+		if (config.checkpoint_interval == 0)
+			COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "CheckpointInterval must be at least 1.");
+		if (!config.checkpoint_file.empty())
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Checkpointing to '{}' every {} iterations/events", config.checkpoint_file, config.checkpoint_interval);
+
+		// runs split over many processes, each a shard with its own stream
+		if(does_key_exist(settings, it, "NumShards"))
+			config.num_shards = std::stoul(it->second);
+		else
+			config.num_shards = 1;
+		if(does_key_exist(settings, it, "ShardIndex"))
+			config.shard_index = std::stoul(it->second);
+		else
+			config.shard_index = 0;
+		if (config.num_shards == 0 || config.shard_index >= config.num_shards)
+			COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "ShardIndex {} is not one of the {} shards.", config.shard_index, config.num_shards);
+		if (config.num_shards > 1 && config.random_seed)
+			COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "The shards of a run must all be given the same nonzero Seed.");
+
+		if(does_key_exist(settings, it, "ResultFile"))
+			config.result_file = it->second;
+		else if (config.num_shards > 1)
+			config.result_file = std::format("shard_{}.colsim", config.shard_index);
+		else
+			config.result_file = "";
+		if (config.num_shards > 1)
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Running shard {} of {}, writing its result to '{}'", config.shard_index, config.num_shards, config.result_file);
+
+		// counters and timers of the run, written out by stop()
+		if(does_key_exist(settings, it, "MetricsFile"))
+			config.metrics_file = it->second;
+		else
+			config.metrics_file = "";
+
+		// timeline of the generation stages, written out by stop()
+		if(does_key_exist(settings, it, "TraceFile"))
+			config.trace_file = it->second;
+		else
+			config.trace_file = "";
+
+		// process string
+		if(does_key_exist(settings, it, "Process"))
+			config.process = it->second;
+		else
+			config.process = "PP2Zg2ll";
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Process string={}", config.process);
+
+		// number if iterations for cross section calculation: REQUIRED
+		if(does_key_exist(settings, it, "NumXSIterations"))
+			config.num_iterations = std::stoi(it->second);
+		else
+			config.num_iterations = 1000000;
+			
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using {} iterations for cross section calculation", config.num_iterations);
+
+		// cutoff energy for phase space generation
+		if(does_key_exist(settings, it, "MinCutoffEnergy")) {
+			config.min_cutoff_energy = std::stod(it->second);
+			if (config.min_cutoff_energy < 1.0)
+				COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "The specified cutoff energy {:.2f} is less than the absolute minimum of 1.0.", config.min_cutoff_energy);
+			else if (config.min_cutoff_energy > 500.0)
+				COLSIM_LOG(LOG_WARNING, "RunConfig::load()", "The specified cutoff energy {:.2f} is higher than ordinary.", config.min_cutoff_energy);
+			config.min_cutoff_energy_2 = config.min_cutoff_energy*config.min_cutoff_energy;
+		} else {
+			config.min_cutoff_energy = 60.0;
+			config.min_cutoff_energy_2 = 60.0*60.0;
+		}
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Setting minimum cutoff energy for cross section calculation to {}", config.min_cutoff_energy);
+
+		// transformation mass/width (also for phase space points): REQUIRED
+		if(does_key_exist(settings, it, "TransformationEnergy")) {
+			config.trans_energy = std::stod(it->second);
+			if (config.trans_energy < config.min_cutoff_energy) {
+				COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "The specified transformation energy {} cannot be less than Q_min.", config.trans_energy);
+			} else if (config.min_cutoff_energy > std::sqrt(config.ecm))
+				COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "The specified transformation energy {} cannot be larger than sqrt(ECM).", config.trans_energy);
+			config.trans_energy_2 = config.trans_energy*config.trans_energy;
+		} else {
+			config.trans_energy = config.min_cutoff_energy;
+			config.trans_energy_2 = config.trans_energy*config.trans_energy;
+		}
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Setting transformation mass/energy to {}", config.trans_energy);
+
+		// keep the electroweak-independent pieces of each event for reweighting
+		if(does_key_exist(settings, it, "StoreMEComponents")) {
+			config.store_me_components = it->second.compare("Yes") == 0;
+		} else {
+			config.store_me_components = false;
+		}
+		if (config.store_me_components)
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Storing matrix element components for electroweak reweighting.");
+
+		// initial evolution scale for parton showering: REQUIRED
+		if(does_key_exist(settings, it, "InitialEvolEnergy")) {
+			config.initial_evol_e = std::stod(it->second);
+			if (config.initial_evol_e < 100.0 || config.initial_evol_e > 5000.0)
+				COLSIM_LOG(LOG_WARNING, "RunConfig::load()", "Initial evolution energy of {} is out of ordinary range of [100.0,5000.0] GeV.", config.initial_evol_e);
+			config.initial_evol_e_2 = config.initial_evol_e*config.initial_evol_e;
+		} else {
+			config.initial_evol_e = 1000.0;
+			config.initial_evol_e_2 = 1000.0*1000.0;
+		}
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Will start parton evolution at {}", config.initial_evol_e);
+
+
+		// used fixed renormalization scale
+		if(does_key_exist(settings, it, "FixedScale")) {
+			config.fixed_scale = it->second.compare("Yes") == 0;
+		} else {
+			config.fixed_scale = true;
+		}
+
+		if (config.fixed_scale) {
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using fixed scale (mass of Z boson) for parton evolution.");
+			COLSIM_LOG(LOG_WARNING, "RunConfig::load()", "A fixed scale misses out on some higher order effects.");
+		}
+		else {
+			COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using variable scale for parton evolution.");
+		}
+
+		if(does_key_exist(settings, it, "EvolutionEnergyCutoff")) {
+			config.evol_energy_cutoff = std::stod(it->second);
+			if (config.evol_energy_cutoff < 1.0) 
+				COLSIM_LOG(LOG_ERROR, "RunConfig::load()", "Minimum cutoff energy for parton evolution MUST be greater than 1.0.");
+			if (config.evol_energy_cutoff >= 100.0)
+				COLSIM_LOG(LOG_WARNING, "RunConfig::load()", "Specified cutoff energy for parton evolution is abnormally high.");
+		} else {
+			config.evol_energy_cutoff = 1.0;
+		}
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Will cut off parton evolution at {:.3f}", config.evol_energy_cutoff);
+
+		// threads used for evolving batches of partons, 0 meaning one per core
+		if(does_key_exist(settings, it, "NumThreads")) {
+			config.num_threads = std::stoul(it->second);
+		} else {
+			config.num_threads = 1;
+		}
+		if (config.num_threads == 0)
+			config.num_threads = std::max(1u, std::thread::hardware_concurrency());
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Using {} thread(s) for parton evolution", config.num_threads);
+
+
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "-----------------------------------------");
+	    COLSIM_LOG(LOG_INFO, "RunConfig::load()", "Finished loading configuration file data.");
+		COLSIM_LOG(LOG_INFO, "RunConfig::load()", "-----------------------------------------");
+
+		return config;
+	}
+
+}; // namespace ColSim
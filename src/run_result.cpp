@@ -0,0 +1,85 @@
+#include "colsim/run_result.hpp"
+
+#include <algorithm>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	void RunResult::merge(RunResult const& other) {
+		if (other.process != process || other.mode != mode || other.ecm != ecm
+			|| other.seed != seed || other.num_shards != num_shards)
+			COLSIM_LOG(LOG_ERROR, "RunResult::merge()", "Results of different runs cannot be merged.");
+		for (uint shard : other.shards)
+			if (std::ranges::find(shards, shard) != shards.end())
+				COLSIM_LOG(LOG_ERROR, "RunResult::merge()", "Shard {} would be counted twice.", shard);
+		if (other.histograms.size() != histograms.size())
+			COLSIM_LOG(LOG_ERROR, "RunResult::merge()", "Results have different histograms.");
+
+		shards.insert(shards.end(), other.shards.begin(), other.shards.end());
+		integration.merge(other.integration);
+		num_events += other.num_events;
+
+		generation_stats.candidates += other.generation_stats.candidates;
+		generation_stats.pre_rejected += other.generation_stats.pre_rejected;
+		generation_stats.evaluated += other.generation_stats.evaluated;
+		generation_stats.accepted += other.generation_stats.accepted;
+		generation_stats.violations += other.generation_stats.violations;
+
+		for (uint i=0; i<histograms.size(); i++)
+			histograms[i].merge(other.histograms[i]);
+	}
+
+	void RunResult::write(std::string const& path) const {
+		CheckpointWriter out(path);
+		out.write(std::string(KIND));
+
+		out.write(process);
+		out.write(mode);
+		out.write(ecm);
+		out.write(seed);
+		out.write(num_shards);
+		out.write(shards);
+
+		out.write(integration.iterations);
+		out.write(integration.weight_sum);
+		out.write(integration.weight_squared_sum);
+		out.write(integration.max_weight);
+		out.write(integration.max_points);
+
+		out.write(num_events);
+		out.write(generation_stats);
+		out.write<uint64_t>(histograms.size());
+		for (Histogram const& h : histograms)
+			h.save(out);
+
+		out.commit();
+	}
+
+	RunResult RunResult::read(std::string const& path) {
+		CheckpointReader in(path);
+		if (in.read_string() != KIND)
+			COLSIM_LOG(LOG_ERROR, "RunResult::read()", "'{}' is not a run result.", path);
+
+		RunResult res{};
+		res.process = in.read_string();
+		res.mode = in.read<uint32_t>();
+		res.ecm = in.read<double>();
+		res.seed = in.read<uint64_t>();
+		res.num_shards = in.read<uint>();
+		in.read(res.shards);
+
+		res.integration.iterations = in.read<uint64_t>();
+		res.integration.weight_sum = in.read<double>();
+		res.integration.weight_squared_sum = in.read<double>();
+		res.integration.max_weight = in.read<double>();
+		in.read(res.integration.max_points);
+
+		res.num_events = in.read<uint64_t>();
+		res.generation_stats = in.read<GenerationStats>();
+		uint64_t num_histograms = in.read<uint64_t>();
+		for (uint64_t i=0; i<num_histograms; i++)
+			res.histograms.push_back(Histogram::load(in));
+		return res;
+	}
+}; // namespace colsim
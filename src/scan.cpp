@@ -0,0 +1,124 @@
+#include "colsim/scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	Scan::Scan(uint num_threads, double target_error)
+		: _num_threads{std::max(1u, num_threads)}, _target_error{target_error}
+	{}
+
+
+	uint64_t Scan::predict_iterations(ScanResult const& neighbour, RunConfig const& config) const {
+		uint64_t limit = config.num_iterations;
+		if (_target_error <= 0.0 || !(neighbour.cross_section > 0.0))
+			return std::min<uint64_t>(MIN_BATCH, limit);
+
+		// the relative variance of a single iteration changes
+		// slowly from point to point, and the error goes as 1/sqrt(n)
+		double rel = neighbour.error/neighbour.cross_section;
+		double needed = static_cast<double>(neighbour.iterations)*(rel/_target_error)*(rel/_target_error);
+		return std::clamp<uint64_t>(static_cast<uint64_t>(needed), std::min<uint64_t>(MIN_BATCH, limit), limit);
+	}
+
+
+	ScanResult Scan::integrate(HardProcess& process, RunConfig const& config,
+							   uint64_t first_batch, Random& rng) const
+	{
+		uint64_t limit = config.num_iterations;
+		uint64_t batch = _target_error > 0.0 ? std::min(first_batch, limit) : limit;
+
+		IntegrationState state{};
+		while (true) {
+			process.integrate(state, batch, rng);
+			if (state.iterations >= limit || _target_error <= 0.0 || !(state.result() > 0.0))
+				break;
+
+			double rel = state.error()/state.result();
+			if (rel <= _target_error)
+				break;
+			double needed = static_cast<double>(state.iterations)*(rel/_target_error)*(rel/_target_error);
+			batch = std::clamp<uint64_t>(static_cast<uint64_t>(needed) - state.iterations,
+										 std::min<uint64_t>(MIN_BATCH, limit - state.iterations), limit - state.iterations);
+		}
+
+		HardProcessResult res = process.finish_integration(state);
+		return ScanResult{res.result, res.error, res.max_weight, state.iterations};
+	}
+
+
+	std::vector<ScanResult> Scan::run(std::vector<RunConfig> points) {
+		uint num_points = points.size();
+		std::vector<ScanResult> results(num_points);
+		if (num_points == 0)
+			return results;
+
+		// points whose PDF set was changed after loading get its handle,
+		// and making the processes loads each set once, before any thread starts
+		for (RunConfig& config : points) {
+			if (!config.pdf || config.pdf->name() != config.pdf_name || config.pdf->member() != config.pdf_mem)
+				config.pdf = PDFSet::get(config.pdf_name, config.pdf_mem, config.pdf_cache_dir);
+			config.update_squares();
+		}
+
+		std::vector<std::unique_ptr<HardProcess>> processes(num_points);
+		for (uint i=0; i<num_points; i++) {
+			processes[i] = Processes::create(points[i].process, points[i]);
+			if (!processes[i])
+				COLSIM_LOG(LOG_ERROR, "Scan::run()", "Unknown process '{}' at scan point {}.", points[i].process, i);
+		}
+
+		// the anchors go first, so that the points after them
+		// rarely have to wait for the one they start from
+		auto anchor_of = [&](uint i) {
+			uint a = (i + ANCHOR_SPACING/2)/ANCHOR_SPACING*ANCHOR_SPACING;
+			return a < num_points ? a : (num_points - 1)/ANCHOR_SPACING*ANCHOR_SPACING;
+		};
+		std::vector<uint> order;
+		order.reserve(num_points);
+		for (uint i=0; i<num_points; i+=ANCHOR_SPACING)
+			order.push_back(i);
+		for (uint i=0; i<num_points; i++)
+			if (i % ANCHOR_SPACING != 0)
+				order.push_back(i);
+
+		uint64_t seed = points.front().seed;
+		std::vector<std::atomic<bool>> done(num_points);
+		std::atomic<uint> next{0};
+		auto work = [&]() {
+			for (uint k=next++; k<num_points; k=next++) {
+				uint i = order[k];
+				Random rng(seed, i);
+				uint64_t first_batch = MIN_BATCH;
+				if (_target_error > 0.0 && i % ANCHOR_SPACING != 0) {
+					uint a = anchor_of(i);
+					done[a].wait(false);
+					first_batch = predict_iterations(results[a], points[i]);
+				}
+				results[i] = integrate(*processes[i], points[i], first_batch, rng);
+				processes[i].reset();
+				done[i] = true;
+				done[i].notify_all();
+			}
+		};
+
+		{
+			uint num_threads = std::min(_num_threads, num_points);
+			std::vector<std::jthread> threads;
+			threads.reserve(num_threads-1);
+			for (uint thread=1; thread<num_threads; thread++)
+				threads.emplace_back(work);
+			work();
+		}
+
+		uint64_t total = 0;
+		for (ScanResult const& r : results)
+			total += r.iterations;
+		COLSIM_LOG(LOG_INFO, "Scan::run()", "Scanned {} points with {} iterations in total", num_points, total);
+		return results;
+	}
+}; // namespace colsim
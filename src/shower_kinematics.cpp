@@ -0,0 +1,152 @@
+#include "colsim/shower_kinematics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "colsim/metrics.hpp"
+#include "colsim/roots.hpp"
+
+namespace colsim
+{
+	namespace
+	{
+		// short enough for the names to be stored without allocating
+		char const* parton_name(int pid)
+		{
+			static constexpr std::array<char const*, 7> QUARKS{"", "d", "u", "s", "c", "b", "t"};
+			static constexpr std::array<char const*, 7> ANTIQUARKS{"", "dbar", "ubar", "sbar", "cbar", "bbar", "tbar"};
+			if (pid == 21)
+				return "g";
+			if (pid >= 1 && pid <= 6)
+				return QUARKS[pid];
+			if (pid <= -1 && pid >= -6)
+				return ANTIQUARKS[-pid];
+			return "";
+		}
+	}
+
+
+	void ShowerKinematics::add_shower(FourVector const& p, int pid, std::span<const Emission> emissions,
+									  Random& rng, std::vector<Particle>& out) const
+	{
+		FourVector follower = p;
+		for (Emission const& e : emissions) {
+			double E = follower.e();
+			double P = follower.p();
+
+			// unit vector along the followed parton and two perpendicular to it
+			std::array<double, 3> n{follower.px()/P, follower.py()/P, follower.pz()/P};
+			std::array<double, 3> a = std::abs(n[2]) < 0.9 ? std::array<double, 3>{0.0, 0.0, 1.0}
+			                                               : std::array<double, 3>{1.0, 0.0, 0.0};
+			std::array<double, 3> u{a[1]*n[2] - a[2]*n[1], a[2]*n[0] - a[0]*n[2], a[0]*n[1] - a[1]*n[0]};
+			double norm = std::sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]);
+			for (double& x : u)
+				x /= norm;
+			std::array<double, 3> v{n[1]*u[2] - n[2]*u[1], n[2]*u[0] - n[0]*u[2], n[0]*u[1] - n[1]*u[0]};
+
+			// both daughters stay massless, which limits the transverse momentum
+			double Eb = e.z*E;
+			double Ec = (1.0-e.z)*E;
+			double pT = std::min(std::sqrt(e.pT_2), std::min(Eb, Ec));
+			double phi = 2.0*M_PI*rng.uniform();
+			double kx = pT*std::cos(phi), ky = pT*std::sin(phi);
+			double Lb = std::sqrt(std::max(0.0, Eb*Eb - pT*pT));
+			double Lc = std::sqrt(std::max(0.0, Ec*Ec - pT*pT));
+
+			FourVector pb{Eb, Lb*n[0] + kx*u[0] + ky*v[0], Lb*n[1] + kx*u[1] + ky*v[1], Lb*n[2] + kx*u[2] + ky*v[2]};
+			FourVector pc{Ec, Lc*n[0] - kx*u[0] - ky*v[0], Lc*n[1] - kx*u[1] - ky*v[1], Lc*n[2] - kx*u[2] - ky*v[2]};
+			out.emplace_back(pc, e.pid, parton_name(e.pid));
+
+			// after g->qqbar the shower follows the quark
+			if (e.pid != 21)
+				pid = -e.pid;
+			follower = pb;
+		}
+		out.emplace_back(follower, pid, parton_name(pid));
+	}
+
+
+	bool ShowerKinematics::reconstruct(Event const& event, EmissionStore const& record, Random& rng,
+									   std::vector<Particle>& out)
+	{
+		uint base = out.size();
+		_groups.clear();
+
+		// everything is done in the rest frame of the final state
+		FourVector total{};
+		for (Particle const& p : event.particles())
+			if (!p.is_incoming())
+				total += p.momentum();
+		double sqrt_s = std::sqrt(total.m_2());
+
+		// the showers are numbered in the order of the outgoing
+		// coloured partons, the same order they were started in
+		uint shower = event.first_shower();
+		for (Particle const& p : event.particles()) {
+			if (p.is_incoming())
+				continue;
+			bool coloured = p.is_coloured();
+			uint index = coloured ? shower++ : 0;
+
+			FourVector momentum = p.momentum();
+			momentum.boost_to_rest(total);
+			uint first = out.size();
+			if (coloured && index < event.first_shower() + event.num_showers())
+				add_shower(momentum, p.pid(), record.shower(index), rng, out);
+			else
+				out.emplace_back(momentum, p.pid(), p.name());
+			_groups.push_back(Group{first, static_cast<uint>(out.size()), momentum, 0.0});
+		}
+		if (_groups.empty())
+			return true;
+
+		// masses the groups have after showering
+		for (Group& g : _groups) {
+			FourVector sum{};
+			for (uint i=g.first; i<g.last; i++)
+				sum += out[i].momentum();
+			g.m_2 = std::max(0.0, sum.m_2());
+		}
+
+		// scale factor k of the three-momenta that gives back the total energy
+		auto energy = [&](double k) {
+			double E = 0.0;
+			for (Group const& g : _groups)
+				E += std::sqrt(k*k*g.momentum.p_2() + g.m_2);
+			return E - sqrt_s;
+		};
+		if (energy(0.0) >= 0.0) {
+			out.erase(out.begin() + base, out.end());
+			return false;
+		}
+		double k = 1.0;
+		if (energy(1.0) > 0.0) {
+			RootResult res = Brent(energy, 0.0, 1.0, RESCALE_TOLERANCE, MAX_RESCALE_ITERATIONS);
+			count(Counter::ROOT_EVALUATIONS, res.evaluations);
+			k = res.root;
+		}
+
+		// move each group onto its scaled momentum, then back to the lab
+		for (Group const& g : _groups) {
+			double px = k*g.momentum.px(), py = k*g.momentum.py(), pz = k*g.momentum.pz();
+			FourVector target{std::sqrt(px*px + py*py + pz*pz + g.m_2), px, py, pz};
+
+			if (g.first + 1 == g.last) {
+				out[g.first].set_momentum(target.boost_from_rest(total));
+				continue;
+			}
+
+			FourVector sum{};
+			for (uint i=g.first; i<g.last; i++)
+				sum += out[i].momentum();
+			for (uint i=g.first; i<g.last; i++) {
+				FourVector p = out[i].momentum();
+				p.boost_to_rest(sum).boost_from_rest(target).boost_from_rest(total);
+				out[i].set_momentum(p);
+			}
+		}
+
+		return true;
+	}
+}; // namespace colsim
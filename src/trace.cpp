@@ -0,0 +1,150 @@
+#include "colsim/trace.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "colsim/utils.hpp"
+
+namespace colsim
+{
+	namespace
+	{
+		/** What one thread recorded. Only that thread adds to it;
+		 *  the lock is there for write() reading it meanwhile.
+		 */
+		struct ThreadTrace
+		{
+			uint tid;
+			std::string name{};
+			std::mutex mutex{};
+			std::vector<TraceEvent> events{};
+
+			ThreadTrace(uint tid) : tid{tid} {}
+		};
+
+		/** The buffers of all threads, those that finished included.
+		 */
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadTrace>> threads{};
+		};
+
+		// never deleted, so that threads finishing during exit still find it
+		Registry& registry() {
+			static Registry* r = new Registry();
+			return *r;
+		}
+
+		// plain data, so it can still be read while the thread is being torn down
+		thread_local ThreadTrace* current = nullptr;
+		thread_local bool thread_gone = false;
+
+		/** Forgets the buffer of a thread when it exits; the
+		 *  buffer itself stays with the registry.
+		 */
+		struct ThreadHandle
+		{
+			~ThreadHandle() {
+				thread_gone = true;
+				current = nullptr;
+			}
+		};
+
+		ThreadTrace* thread_trace() {
+			if (current || thread_gone)
+				return current;
+
+			thread_local ThreadHandle handle{};
+			Registry& r = registry();
+			std::lock_guard lock(r.mutex);
+			// numbered from 1, as some viewers hide thread 0
+			r.threads.push_back(std::make_unique<ThreadTrace>(r.threads.size() + 1));
+			current = r.threads.back().get();
+			return current;
+		}
+	}
+
+
+	Tracer& Tracer::instance() {
+		static Tracer* tracer = new Tracer();
+		return *tracer;
+	}
+
+
+	void Tracer::enable() {
+		static std::once_flag once;
+		std::call_once(once, [this]() {
+			_epoch = std::chrono::steady_clock::now();
+			_enabled.store(true, std::memory_order_release);
+		});
+	}
+
+
+	void Tracer::record(TraceEvent const& event) {
+		ThreadTrace* t = thread_trace();
+		if (!t)
+			return;
+		std::lock_guard lock(t->mutex);
+		t->events.push_back(event);
+	}
+
+
+	void Tracer::name_thread(std::string const& name) {
+		if (!enabled())
+			return;
+		ThreadTrace* t = thread_trace();
+		if (!t)
+			return;
+		std::lock_guard lock(t->mutex);
+		t->name = name;
+	}
+
+
+	void Tracer::write(std::string const& path) const {
+		std::string json = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+		bool first = true;
+		auto append = [&](std::string const& line) {
+			json += first ? "  " : ",\n  ";
+			json += line;
+			first = false;
+		};
+
+		uint num_events = 0;
+		{
+			Registry& r = registry();
+			std::lock_guard lock(r.mutex);
+			for (std::unique_ptr<ThreadTrace> const& t : r.threads) {
+				std::lock_guard thread_lock(t->mutex);
+				append(std::format(R"({{"ph": "M", "name": "thread_name", "pid": 1, "tid": {}, "args": {{"name": "{}"}}}})",
+								   t->tid, t->name.empty() ? std::format("thread {}", t->tid) : t->name));
+				append(std::format(R"({{"ph": "M", "name": "thread_sort_index", "pid": 1, "tid": {}, "args": {{"sort_index": {}}}}})",
+								   t->tid, t->tid));
+
+				// complete events, in microseconds, each one carrying its own end
+				for (TraceEvent const& e : t->events) {
+					std::string line = std::format(R"({{"ph": "X", "name": "{}", "cat": "{}", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f})",
+												   e.name, e.category, t->tid, 1e-3*static_cast<double>(e.start_ns), 1e-3*static_cast<double>(e.duration_ns));
+					if (e.arg_name)
+						line += std::format(R"(, "args": {{"{}": {}}})", e.arg_name, e.arg);
+					line += "}";
+					append(line);
+				}
+				num_events += t->events.size();
+			}
+		}
+		json += "\n]}\n";
+
+		std::ofstream out(path, std::ios::trunc);
+		out << json;
+		out.close();
+		if (!out)
+			COLSIM_LOG(LOG_WARNING, "Tracer::write()", "Could not write the trace to '{}'", path);
+		else
+			COLSIM_LOG(LOG_INFO, "Tracer::write()", "Wrote {} stages to the trace '{}'", num_events, path);
+	}
+}; // namespace colsim
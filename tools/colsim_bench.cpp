@@ -0,0 +1,612 @@
+/** Times the pieces of the generator that the run time is made of:
+ *
+ *     colsim_bench [--config <file>] [--filter <text>] [--min-time <seconds>]
+ *                  [--json <file>] [--label <text>] [--compare <file>]
+ *
+ *  Each benchmark is run with a doubling number of operations until one
+ *  run takes --min-time (0.2 s by default), then REPEATS more times, and
+ *  the median is reported as ns/op, ops/s and the heap allocations per
+ *  operation of the benchmarking thread. The results are written as JSON
+ *  to --json (colsim_bench.json by default), labelled with --label, and
+ *  --compare prints the change against such a file from an earlier build.
+ *
+ *  The configuration is the default one unless --config gives a file,
+ *  and only benchmarks whose name contains --filter are run. Build
+ *  with CMAKE_BUILD_TYPE=Release for numbers worth comparing.
+ */
+#include "colsim/alphas.hpp"
+#include "colsim/emission_store.hpp"
+#include "colsim/fourvector.hpp"
+#include "colsim/hard_process.hpp"
+#include "colsim/math.hpp"
+#include "colsim/metrics.hpp"
+#include "colsim/parton_shower.hpp"
+#include "colsim/pdf.hpp"
+#include "colsim/random.hpp"
+#include "colsim/roots.hpp"
+#include "colsim/run_config.hpp"
+#include "colsim/utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef COLSIM_BUILD_TYPE
+#define COLSIM_BUILD_TYPE ""
+#endif
+
+using namespace colsim;
+
+
+// heap allocations of each thread, so that the logger's
+// background thread does not count against a benchmark
+namespace
+{
+	thread_local uint64_t thread_allocations = 0;
+	thread_local uint64_t thread_allocated_bytes = 0;
+
+	// Every operator new and delete below goes through these two. They are
+	// kept out of line so that GCC cannot see free() paired with an
+	// operator new and warn about mismatched allocation functions.
+	[[gnu::noinline]] void* allocate(std::size_t size, std::size_t alignment) {
+		thread_allocations++;
+		thread_allocated_bytes += size;
+		size = size ? size : 1;
+		void* p = alignment > alignof(std::max_align_t)
+			? std::aligned_alloc(alignment, (size + alignment - 1)/alignment*alignment)
+			: std::malloc(size);
+		if (!p)
+			throw std::bad_alloc();
+		return p;
+	}
+
+	[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+}
+
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+
+
+namespace
+{
+	constexpr uint REPEATS = 5;
+	// phase space points, PDF arguments etc. are drawn up front
+	// and cycled through, so that drawing them is not timed
+	constexpr uint NUM_INPUTS = 4096;
+
+	/** Keeps the compiler from dropping a computation whose result is unused.
+	 */
+	template <typename T>
+	inline void keep(T const& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	struct BenchResult
+	{
+		std::string name;
+		uint64_t ops{0};
+		double ns_per_op{0.0};
+		double allocs_per_op{0.0};
+		double bytes_per_op{0.0};
+		// anything else worth keeping, e.g. an unweighting efficiency
+		std::vector<std::pair<std::string, double>> extra{};
+
+		inline double ops_per_s() const { return ns_per_op > 0.0 ? 1e9/ns_per_op : 0.0; }
+	};
+
+	/** A benchmark does @a n operations per call. */
+	using BenchFunc = std::function<void(uint64_t n)>;
+
+	class Bench
+	{
+	private:
+		std::string _filter;
+		double _min_time;
+		std::vector<BenchResult> _results{};
+
+	public:
+		Bench(std::string const& filter, double min_time)
+			: _filter{filter}, _min_time{min_time}
+		{}
+
+		inline std::vector<BenchResult> const& results() const { return _results; }
+
+		inline bool selected(std::string const& name) const {
+			return _filter.empty() || name.find(_filter) != std::string::npos;
+		}
+
+		/** Times @a func, adding what @a extra returns afterwards to the
+		 *  result. Returns false if the benchmark was filtered out.
+		 */
+		bool run(std::string const& name, BenchFunc const& func,
+				 std::function<std::vector<std::pair<std::string, double>>()> const& extra = {})
+		{
+			if (!selected(name))
+				return false;
+
+			// warm up, and find how many operations take long enough
+			uint64_t n = 1;
+			while (true) {
+				double t = time(func, n);
+				if (t >= _min_time || n >= (uint64_t{1} << 40))
+					break;
+				n = t > 0.0 ? std::max<uint64_t>(2*n, static_cast<uint64_t>(1.2*n*_min_time/t)) : 2*n;
+			}
+
+			std::vector<double> ns(REPEATS);
+			uint64_t allocations = 0, bytes = 0;
+			for (uint r=0; r<REPEATS; r++) {
+				uint64_t a0 = thread_allocations, b0 = thread_allocated_bytes;
+				ns[r] = 1e9*time(func, n)/static_cast<double>(n);
+				allocations += thread_allocations - a0;
+				bytes += thread_allocated_bytes - b0;
+			}
+			std::ranges::sort(ns);
+
+			BenchResult res{name, n, ns[REPEATS/2],
+							static_cast<double>(allocations)/static_cast<double>(REPEATS*n),
+							static_cast<double>(bytes)/static_cast<double>(REPEATS*n)};
+			if (extra)
+				res.extra = extra();
+			print(res);
+			_results.push_back(std::move(res));
+			return true;
+		}
+
+	private:
+		/** Seconds taken by @a n operations. */
+		static double time(BenchFunc const& func, uint64_t n) {
+			auto start = std::chrono::steady_clock::now();
+			func(n);
+			auto stop = std::chrono::steady_clock::now();
+			return std::chrono::duration<double>(stop - start).count();
+		}
+
+		static void print(BenchResult const& res) {
+			std::cout << std::format("{:<32} {:>12.1f} ns/op {:>14.0f} ops/s {:>9.3f} allocs/op",
+									 res.name, res.ns_per_op, res.ops_per_s(), res.allocs_per_op);
+			for (auto const& [key, value] : res.extra)
+				std::cout << std::format("  {} {:.4g}", key, value);
+			std::cout << '\n';
+		}
+	};
+
+
+	std::string to_json(std::vector<BenchResult> const& results, std::string const& label) {
+		std::string json = std::format("{{\n  \"label\": \"{}\",\n  \"build_type\": \"{}\",\n  \"metrics\": {},\n  \"log_level\": {},\n  \"benchmarks\": [\n",
+									   label, COLSIM_BUILD_TYPE, COLSIM_METRICS ? "true" : "false", COLSIM_LOG_LEVEL);
+		for (uint i=0; i<results.size(); i++) {
+			BenchResult const& r = results[i];
+			// one benchmark per line, which --compare relies on
+			json += std::format("    {{\"name\": \"{}\", \"ops\": {}, \"ns_per_op\": {:.3f}, \"ops_per_s\": {:.1f}, \"allocs_per_op\": {:.4f}, \"bytes_per_op\": {:.1f}",
+								r.name, r.ops, r.ns_per_op, r.ops_per_s(), r.allocs_per_op, r.bytes_per_op);
+			for (auto const& [key, value] : r.extra)
+				json += std::format(", \"{}\": {:.6g}", key, value);
+			json += i+1 < results.size() ? "},\n" : "}\n";
+		}
+		json += "  ]\n}\n";
+		return json;
+	}
+
+
+	/** Value of @a key in one line written by to_json(), if it is there.
+	 */
+	bool json_field(std::string const& line, std::string const& key, std::string& value) {
+		std::string pattern = std::format("\"{}\": ", key);
+		size_t start = line.find(pattern);
+		if (start == std::string::npos)
+			return false;
+		start += pattern.size();
+		size_t end = line.find_first_of(",}", start);
+		value = line.substr(start, end - start);
+		if (value.size() >= 2 && value.front() == '"')
+			value = value.substr(1, value.size() - 2);
+		return true;
+	}
+
+	void compare(std::vector<BenchResult> const& results, std::string const& path) {
+		std::ifstream in(path);
+		if (!in)
+			COLSIM_LOG(LOG_ERROR, "colsim_bench", "Could not open '{}' to compare with", path);
+
+		std::cout << std::format("\n{:<32} {:>12} {:>12} {:>8}\n", "compared with " + path, "before", "now", "change");
+		std::string line, name, ns;
+		while (std::getline(in, line)) {
+			if (!json_field(line, "name", name) || !json_field(line, "ns_per_op", ns))
+				continue;
+			auto it = std::ranges::find(results, name, &BenchResult::name);
+			if (it == results.end())
+				continue;
+			double before = std::stod(ns);
+			std::cout << std::format("{:<32} {:>9.1f} ns {:>9.1f} ns {:>+7.1f}%\n",
+									 name, before, it->ns_per_op, 100.0*(it->ns_per_op/before - 1.0));
+		}
+	}
+
+
+	/** dsigma() alone, and calculate() and generation as a whole, for @a TProcess.
+	 */
+	template <typename TProcess>
+	void bench_process(Bench& bench, RunConfig const& config) {
+		std::string name{TProcess::name};
+		std::string dsigma_name = "dsigma/" + name;
+		std::string calculate_name = "calculate/" + name;
+		std::string generate_name = "generate_event/" + name;
+		if (!bench.selected(dsigma_name) && !bench.selected(calculate_name) && !bench.selected(generate_name))
+			return;
+
+		constexpr uint N = TProcess::num_dims;
+		TProcess process(config);
+		auto const& phase_space = dynamic_cast<PhaseSpace<N> const&>(process.get_phase_space());
+
+		Random rng(config.seed, 0);
+		std::vector<typename TProcess::point_type> points(NUM_INPUTS);
+		for (auto& point : points)
+			phase_space.fill_phase_space(point, rng);
+
+		bench.run(dsigma_name, [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++)
+				keep(process.dsigma(std::span<const double, N>(points[i % NUM_INPUTS])).weight);
+		});
+
+		// a run of calculate() with n iterations
+		bench.run(calculate_name, [&](uint64_t n) {
+			IntegrationState state{};
+			while (n > 0) {
+				uint batch = static_cast<uint>(std::min<uint64_t>(n, 1u << 30));
+				process.integrate(state, batch, rng);
+				n -= batch;
+			}
+			keep(process.finish_integration(state).result);
+		});
+
+		if (!bench.selected(generate_name))
+			return;
+
+		// as generate_event() does it, against the envelope of a full calculate()
+		HardProcessResult res = process.calculate(rng);
+		std::vector<Event> events;
+		std::vector<std::vector<double>> plot_points;
+		GenerationStats before = process.generation_stats();
+		bench.run(generate_name, [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				// cleared now and then, keeping their memory, like a run that writes its events out
+				if (events.size() == 1024) {
+					events.clear();
+					plot_points.clear();
+				}
+				process.generate(1, res.max_weight, events, plot_points, rng);
+			}
+		}, [&]() {
+			GenerationStats const& after = process.generation_stats();
+			double candidates = static_cast<double>(after.candidates - before.candidates);
+			double evaluated = static_cast<double>(after.evaluated - before.evaluated);
+			double accepted = static_cast<double>(after.accepted - before.accepted);
+			return std::vector<std::pair<std::string, double>>{
+				{"unweighting_efficiency", accepted/candidates},
+				{"events_per_dsigma", accepted/evaluated}
+			};
+		});
+	}
+
+
+	void bench_shower(Bench& bench, RunConfig const& config) {
+		PartonShower quark(config);
+		GluonShower gluon(config);
+
+		// as ColSimMain sets up its showers
+		double scale = config.fixed_scale ? config.initial_evol_e/2.0 : config.evol_energy_cutoff;
+		double alphas_over = quark.alphas().alphas_over(scale);
+
+		Random rng(config.seed, 1);
+		EmissionStore store;
+		for (auto [name, shower] : {std::pair<char const*, PartonShower*>{"evolve/quark", &quark},
+									std::pair<char const*, PartonShower*>{"evolve/gluon", &gluon}}) {
+			// over every run of the benchmark, the warm up included
+			uint64_t num_evolves = 0;
+			Metrics before = Metrics::collect();
+			bench.run(name, [&](uint64_t n) {
+				for (uint64_t i=0; i<n; i++) {
+					if (store.num_showers() == 1024)
+						store.clear();
+					shower->evolve(config.initial_evol_e, config.evol_energy_cutoff, alphas_over, store, rng);
+				}
+				num_evolves += n;
+			}, [&]() {
+				// the shower solves for its emission scales with SafeguardedNewton(),
+				// whose evaluations only the metrics count
+				std::vector<std::pair<std::string, double>> extra{};
+				if constexpr (COLSIM_METRICS) {
+					Metrics counted = Metrics::collect() - before;
+					extra.emplace_back("safeguarded_newton_evaluations_per_evolve",
+									   static_cast<double>(counted[Counter::ROOT_EVALUATIONS])/static_cast<double>(num_evolves));
+				}
+				return extra;
+			});
+		}
+	}
+
+
+	/** Opens up the shower's emission scale equation,
+	 *  so that every root finder can be run on it.
+	 */
+	class EmissionScaleSolves : public PartonShower
+	{
+	public:
+		static constexpr double TOLERANCE = NEWTON_TOLERANCE;
+		static constexpr uint MAX_ITERATIONS = 100;
+
+		/** One step, with @a lo below the root, to bracket it with @a eq.l0.
+		 */
+		struct Input
+		{
+			EmissionScaleEquation eq;
+			Overestimate over;
+			double lo;
+		};
+
+	private:
+		double _alphas_over;
+		std::vector<Input> _inputs{};
+
+	public:
+		/** Steps of quark and gluon showers from scales between the
+		 *  cutoff and the starting scale, keeping only those that emit,
+		 *  so that every solver has a root to find. The shower's Newton
+		 *  solve needs no bracket; for the others the lower end is the
+		 *  vertex of the quadratic bound on the equation, where the
+		 *  equation is negative whenever there is an emission to find.
+		 */
+		EmissionScaleSolves(RunConfig const& config, Random& rng)
+			: PartonShower(config)
+		{
+			// as ColSimMain sets up its showers
+			double scale = config.fixed_scale ? config.initial_evol_e/2.0 : config.evol_energy_cutoff;
+			_alphas_over = _alphas.alphas_over(scale);
+
+			double Qcut = config.evol_energy_cutoff;
+			double log_min = std::log(std::sqrt(FAC_CUTOFF)*Qcut);
+			double log_max = std::log(config.initial_evol_e);
+			while (_inputs.size() < NUM_INPUTS) {
+				double Q = std::exp(log_min + rng.uniform()*(log_max - log_min));
+				PartonKind kind = _inputs.size() % 2 ? PartonKind::GLUON : PartonKind::QUARK;
+				Input in{{}, step_overestimate(kind, Q, Qcut), 0.0};
+				if (!emission_scale_equation(Q, Qcut, rng.uniform(), FAC_T, _alphas_over, in.over, in.eq))
+					continue;
+
+				// (l - lQ)(A l + B) with A = a c_log/2 and B = a c_flat is lowest here
+				in.lo = std::max(in.eq.l_min, 0.5*(in.eq.lQ - 2.0*in.over.c_flat/in.over.c_log));
+				if (in.lo < in.eq.l0 && value(in, in.lo) < 0.0)
+					_inputs.push_back(in);
+			}
+		}
+
+		inline std::vector<Input> const& inputs() const { return _inputs; }
+
+		inline std::pair<double, double> func(Input const& in, double l) const {
+			return emission_scale_func(l, in.eq.lQ, in.eq.log_r, _alphas_over, in.over);
+		}
+		inline double value(Input const& in, double l) const { return func(in, l).first; }
+	};
+
+
+	/** Each root finder on the emission scale equation of the shower,
+	 *  with the number of function evaluations each solve takes.
+	 */
+	void bench_roots(Bench& bench, RunConfig const& config) {
+		if (!bench.selected("roots/"))
+			return;
+
+		Random rng(config.seed, 5);
+		EmissionScaleSolves solves(config, rng);
+		auto const& inputs = solves.inputs();
+		constexpr double tol = EmissionScaleSolves::TOLERANCE;
+		constexpr uint max_iterations = EmissionScaleSolves::MAX_ITERATIONS;
+
+		// over every run of a benchmark, the warm up included
+		uint64_t evaluations = 0, num_solves = 0;
+		auto per_solve = [&]() {
+			double result = static_cast<double>(evaluations)/static_cast<double>(num_solves);
+			evaluations = num_solves = 0;
+			return std::vector<std::pair<std::string, double>>{{"evaluations_per_solve", result}};
+		};
+
+		bench.run("roots/brent", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto const& in = inputs[i % NUM_INPUTS];
+				RootResult res = Brent([&](double l) { return solves.value(in, l); },
+									   in.lo, in.eq.l0, tol, max_iterations);
+				evaluations += res.evaluations;
+				keep(res.root);
+			}
+			num_solves += n;
+		}, per_solve);
+
+		bench.run("roots/illinois", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto const& in = inputs[i % NUM_INPUTS];
+				RootResult res = Illinois([&](double l) { return solves.value(in, l); },
+										  in.lo, in.eq.l0, tol, max_iterations);
+				evaluations += res.evaluations;
+				keep(res.root);
+			}
+			num_solves += n;
+		}, per_solve);
+
+		// as the shower solves it
+		bench.run("roots/safeguarded_newton", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto const& in = inputs[i % NUM_INPUTS];
+				RootResult res = SafeguardedNewton([&](double l) { return solves.func(in, l); },
+												   in.eq.l0, in.eq.l_min, in.eq.l0, tol, max_iterations);
+				evaluations += res.evaluations;
+				keep(res.root);
+			}
+			num_solves += n;
+		}, per_solve);
+
+		// Bisection() returns no RootResult, so its calls are counted here
+		bench.run("roots/bisection", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto const& in = inputs[i % NUM_INPUTS];
+				auto func = [&](double l, void*) {
+					evaluations++;
+					return solves.value(in, l);
+				};
+				keep(Bisection(func, in.lo, in.eq.l0, max_iterations, tol, nullptr));
+			}
+			num_solves += n;
+		}, per_solve);
+	}
+
+
+	void bench_alphas(Bench& bench, RunConfig const& config) {
+		AlphaS alphas(1, config);
+		Random rng(config.seed, 2);
+		double log_min = std::log(config.evol_energy_cutoff*config.evol_energy_cutoff);
+		double log_max = std::log(config.initial_evol_e_2);
+		std::vector<double> ts(NUM_INPUTS);
+		for (double& t : ts)
+			t = std::exp(log_min + rng.uniform()*(log_max - log_min));
+
+		bench.run("alphas/calc_alphas", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++)
+				keep(alphas.calc_alphas(ts[i % NUM_INPUTS]));
+		});
+		bench.run("alphas/table", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++)
+				keep(alphas.alphas(ts[i % NUM_INPUTS]));
+		});
+	}
+
+
+	void bench_pdf(Bench& bench, RunConfig const& config) {
+		if (!bench.selected("pdf/"))
+			return;
+		config.pdf->load();
+		PDFSet const& pdf = *config.pdf;
+
+		// the x and Q2 of Drell-Yan pairs above the cutoff
+		Random rng(config.seed, 3);
+		std::vector<std::pair<double, double>> args(NUM_INPUTS);
+		for (auto& [x, q2] : args) {
+			q2 = config.min_cutoff_energy_2*std::pow(config.s/config.min_cutoff_energy_2, rng.uniform()*0.5);
+			x = std::sqrt(q2/config.s)*std::exp(rng.uniform()*2.0 - 1.0);
+			x = std::min(x, 0.99);
+		}
+
+		bench.run("pdf/xfxQ2", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto [x, q2] = args[i % NUM_INPUTS];
+				keep(pdf.xfxQ2(2, x, q2));
+			}
+		});
+		std::vector<double> xfs;
+		bench.run("pdf/xfxQ2_all_partons", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				auto [x, q2] = args[i % NUM_INPUTS];
+				pdf.xfxQ2(x, q2, xfs);
+				keep(xfs[6]);
+			}
+		});
+		bench.run("pdf/alphasQ2", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++)
+				keep(pdf.alphasQ2(args[i % NUM_INPUTS].second));
+		});
+	}
+
+
+	void bench_fourvector(Bench& bench, RunConfig const& config) {
+		Random rng(config.seed, 4);
+		std::vector<FourVector> vectors(1024);
+		for (FourVector& v : vectors) {
+			double px = rng.uniform() - 0.5, py = rng.uniform() - 0.5, pz = rng.uniform() - 0.5;
+			v = FourVector{std::sqrt(px*px + py*py + pz*pz + 0.1), px, py, pz};
+		}
+		double bx = 0.3, by = -0.2, bz = 0.5;
+
+		// there and back, so that the vectors stay as they were
+		bench.run("fourvector/boost", [&](uint64_t n) {
+			for (uint64_t i=0; i<n; i++) {
+				FourVector& v = vectors[i % vectors.size()];
+				if (i % 2 == 0)
+					v.boost(bx, by, bz);
+				else
+					v.boost(-bx, -by, -bz);
+				keep(v);
+			}
+		});
+	}
+}
+
+
+int main(int argc, char* argv[]) {
+	std::string config_path{}, filter{}, json_path{"colsim_bench.json"}, label{}, compare_path{};
+	double min_time = 0.2;
+	for (int i=1; i<argc; i++) {
+		std::string arg = argv[i];
+		if (i+1 >= argc) {
+			std::cerr << std::format("colsim_bench: '{}' needs a value\n", arg);
+			return EXIT_FAILURE;
+		}
+		std::string value = argv[++i];
+		if (arg == "--config")
+			config_path = value;
+		else if (arg == "--filter")
+			filter = value;
+		else if (arg == "--min-time")
+			min_time = std::stod(value);
+		else if (arg == "--json")
+			json_path = value;
+		else if (arg == "--label")
+			label = value;
+		else if (arg == "--compare")
+			compare_path = value;
+		else {
+			std::cerr << "usage: colsim_bench [--config <file>] [--filter <text>] [--min-time <seconds>]\n"
+						 "                    [--json <file>] [--label <text>] [--compare <file>]\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	RunConfig config = RunConfig::load(config_path);
+	Logger::instance().flush();
+	if (std::string_view(COLSIM_BUILD_TYPE) != "Release")
+		COLSIM_LOG(LOG_WARNING, "colsim_bench", "Built as '{}' rather than Release; the timings say little.", COLSIM_BUILD_TYPE);
+
+	Bench bench(filter, min_time);
+	for (std::string_view name : Processes::names)
+		Processes::visit(name, [&]<typename TProcess>() { bench_process<TProcess>(bench, config); });
+	bench_shower(bench, config);
+	bench_roots(bench, config);
+	bench_alphas(bench, config);
+	bench_pdf(bench, config);
+	bench_fourvector(bench, config);
+
+	std::ofstream out(json_path, std::ios::trunc);
+	out << to_json(bench.results(), label);
+	out.close();
+	if (!out)
+		COLSIM_LOG(LOG_ERROR, "colsim_bench", "Could not write the results to '{}'", json_path);
+	COLSIM_LOG(LOG_INFO, "colsim_bench", "Wrote {} results to '{}'", bench.results().size(), json_path);
+
+	if (!compare_path.empty())
+		compare(bench.results(), compare_path);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/** Merges the result files written by the shards of a run
+ *  (see 'NumShards' and 'ShardIndex') into one:
+ *
+ *     colsim_merge <output> <shard file>...
+ *
+ *  The merged result is written to <output>, and can itself be merged
+ *  again. The cross section and the histograms, normalized to the
+ *  differential cross section, are printed.
+ */
+#include "colsim/run_result.hpp"
+#include "colsim/utils.hpp"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <string>
+
+using namespace colsim;
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cerr << "usage: colsim_merge <output> <shard file>...\n";
+		return EXIT_FAILURE;
+	}
+
+	RunResult merged = RunResult::read(argv[2]);
+	for (int i=3; i<argc; i++)
+		merged.merge(RunResult::read(argv[i]));
+	merged.write(argv[1]);
+
+	if (!merged.complete())
+		COLSIM_LOG(LOG_WARNING, "colsim_merge", "Only {} of the {} shards were merged.", merged.shards.size(), merged.num_shards);
+	COLSIM_LOG(LOG_INFO, "colsim_merge", "Merged {} shard(s) of '{}' into '{}'", merged.shards.size(), merged.process, argv[1]);
+
+	if (merged.integration.iterations > 0)
+		std::cout << std::format("cross section: {:.9f} +- {:.9f} pb from {} iterations, maximum weight {:.9f}\n",
+								 merged.cross_section(), merged.cross_section_error(),
+								 merged.integration.iterations, merged.integration.max_weight);
+	std::cout << std::format("events: {}\n", merged.num_events);
+	if (merged.num_events == 0)
+		return EXIT_SUCCESS;
+
+	// unweighted events, so each stands for an equal share of the cross
+	// section; without a cross section, counts are per event
+	double per_event = merged.integration.iterations > 0 ? merged.cross_section() : 1.0;
+	per_event /= static_cast<double>(merged.num_events);
+	for (Histogram const& h : merged.histograms) {
+		std::cout << std::format("\n# {}\n# low high value error\n", h.name());
+		double norm = per_event/h.width();
+		for (uint i=0; i<h.bins(); i++) {
+			double low = h.low() + i*h.width();
+			std::cout << std::format("{:.6g} {:.6g} {:.9g} {:.9g}\n",
+									 low, low + h.width(), norm*h.sum_w(i), norm*std::sqrt(h.sum_w2(i)));
+		}
+	}
+
+	return EXIT_SUCCESS;
+}